@@ -97,7 +97,7 @@ namespace auth
 				return false;
 			}
 
-			const utils::info_string info_string{std::string{params[2]}};
+			const utils::info_string info_string{std::string_view{params[2]}};
 			const auto challenge = info_string.get("challenge");
 
 			connect_string.clear();
@@ -137,9 +137,9 @@ namespace auth
 				return;
 			}
 
-			const utils::info_string info_string{std::string{params[2]}};
-			const auto steam_id = info_string.get("xuid");
-			const auto challenge = info_string.get("challenge");
+			const utils::info_string_view info_string{params[2]};
+			const std::string steam_id{info_string.get("xuid")};
+			const std::string challenge{info_string.get("challenge")};
 
 			if (steam_id.empty() || challenge.empty())
 			{
@@ -194,7 +194,8 @@ namespace command
 
 	void add_raw(const char* name, void (*callback)())
 	{
-		game::Cmd_AddCommandInternal(name, callback, utils::memory::get_allocator()->allocate<game::cmd_function_s>());
+		// Commands are never unregistered, so their storage can come from the arena
+		game::Cmd_AddCommandInternal(name, callback, utils::memory::get_allocator()->allocate_arena<game::cmd_function_s>());
 	}
 
 	void add(const char* name, const std::function<void(const params&)>& callback)
@@ -419,6 +420,16 @@ namespace command
 				}
 			});
 
+			add("memoryStats", []
+			{
+				const auto stats = utils::memory::get_allocator()->get_statistics();
+
+				console::info("Live: %zu bytes in %zu allocations (peak %zu bytes)\n", stats.live_bytes, stats.live_allocations,
+				              stats.peak_bytes);
+				console::info("Arena: %zu of %zu bytes used\n", stats.arena_bytes, stats.arena_capacity);
+				console::info("Total allocations: %zu\n", stats.allocation_count);
+			});
+
 			add("vstr", [](const params& params)
 			{
 				if (params.size() < 2)
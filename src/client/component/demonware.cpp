@@ -2,6 +2,8 @@
 #include "loader/component_loader.hpp"
 #include "demonware.hpp"
 #include "game_module.hpp"
+#include "command.hpp"
+#include "console.hpp"
 
 #include <utils/hook.hpp>
 #include <utils/nt.hpp>
@@ -12,6 +14,8 @@
 
 #include "game/demonware/stun_server.hpp"
 #include "game/demonware/service_server.hpp"
+#include "game/demonware/service_dispatcher.hpp"
+#include "game/demonware/socket_registry.hpp"
 
 #include "game/demonware/services/bdLSGHello.hpp"       // 7
 #include "game/demonware/services/bdStorage.hpp"        // 10
@@ -35,13 +39,20 @@ namespace demonware
 	{
 		volatile bool terminate;
 		std::thread message_thread;
+		std::mutex message_mutex;
+		std::condition_variable message_condition;
+		bool message_pending = false;
 		std::recursive_mutex server_mutex;
-		std::map<SOCKET, bool> blocking_sockets;
+		std::atomic<uint64_t> server_mutex_contentions{0};
+		socket_registry tracked_sockets;
 		std::map<SOCKET, std::shared_ptr<service_server>> socket_links;
 		std::map<unsigned long, std::shared_ptr<service_server>> servers;
+		std::unique_ptr<service_dispatcher> dispatcher;
 		std::map<unsigned long, std::shared_ptr<stun_server>> stun_servers;
 		std::map<SOCKET, std::queue<std::pair<std::string, std::string>>> datagram_packets;
 
+		// Written by bdLSGHello, read by replies and packets being processed on dispatcher threads
+		std::mutex key_mutex;
 		uint8_t encryption_key_[24];
 		uint8_t decryption_key_[24];
 
@@ -83,9 +94,26 @@ namespace demonware
 			return find_stun_server_by_address(utils::cryptography::jenkins_one_at_a_time::compute(name));
 		}
 
+		std::unique_lock<std::recursive_mutex> lock_socket_state()
+		{
+			std::unique_lock<std::recursive_mutex> lock(server_mutex, std::try_to_lock);
+			if (!lock.owns_lock())
+			{
+				server_mutex_contentions.fetch_add(1, std::memory_order_relaxed);
+				lock.lock();
+			}
+
+			return lock;
+		}
+
 		std::shared_ptr<service_server> find_server_by_socket(const SOCKET s)
 		{
-			std::lock_guard<std::recursive_mutex> _(server_mutex);
+			if (!tracked_sockets.is_tracked(s, socket_registry::linked))
+			{
+				return std::shared_ptr<service_server>();
+			}
+
+			const auto _ = lock_socket_state();
 
 			const auto server = socket_links.find(s);
 			if (server != socket_links.end())
@@ -102,6 +130,7 @@ namespace demonware
 
 			const auto server = find_server_by_address(address);
 			if (!server) return false;
+			if (!tracked_sockets.set_flags(s, socket_registry::linked)) return false;
 
 			socket_links[s] = server;
 			return true;
@@ -109,7 +138,9 @@ namespace demonware
 
 		void unlink_socket(const SOCKET sock)
 		{
-			std::lock_guard<std::recursive_mutex> _(server_mutex);
+			if (!tracked_sockets.get_flags(sock)) return;
+
+			const auto _ = lock_socket_state();
 
 			const auto server = socket_links.find(sock);
 			if (server != socket_links.end())
@@ -122,15 +153,16 @@ namespace demonware
 			{
 				datagram_packets.erase(dgram_packets);
 			}
+
+			tracked_sockets.erase(sock);
 		}
 
 		bool is_blocking_socket(const SOCKET s, const bool def)
 		{
-			std::lock_guard<std::recursive_mutex> _(server_mutex);
-
-			if (blocking_sockets.find(s) != blocking_sockets.end())
+			const auto flags = tracked_sockets.get_flags(s);
+			if (flags & socket_registry::blocking_set)
 			{
-				return blocking_sockets[s];
+				return (flags & socket_registry::blocking) != 0;
 			}
 
 			return def;
@@ -138,7 +170,9 @@ namespace demonware
 
 		int recv_datagam_packet(const SOCKET s, char* buf, const int len, sockaddr* from, int* fromlen)
 		{
-			std::unique_lock<std::recursive_mutex> lock(server_mutex);
+			if (!tracked_sockets.is_tracked(s, socket_registry::datagram)) return 0;
+
+			auto lock = lock_socket_state();
 
 			auto queue = datagram_packets.find(s);
 			if (queue != datagram_packets.end())
@@ -173,21 +207,12 @@ namespace demonware
 			return 0;
 		}
 
-		void remove_blocking_socket(const SOCKET s)
-		{
-			std::lock_guard<std::recursive_mutex> _(server_mutex);
-
-			const auto entry = blocking_sockets.find(s);
-			if (entry != blocking_sockets.end())
-			{
-				blocking_sockets.erase(entry);
-			}
-		}
-
 		void set_blocking_socket(const SOCKET s, const bool blocking)
 		{
-			std::lock_guard<std::recursive_mutex> _(server_mutex);
-			blocking_sockets[s] = blocking;
+			const auto _ = lock_socket_state();
+
+			const uint32_t flags = socket_registry::blocking_set | (blocking ? socket_registry::blocking : 0);
+			tracked_sockets.set_flags(s, flags, socket_registry::blocking);
 		}
 
 		void server_thread()
@@ -195,16 +220,34 @@ namespace demonware
 			terminate = false;
 			while (!terminate)
 			{
-				std::unique_lock<std::recursive_mutex> lock(server_mutex);
-
-				for (auto& server : servers)
 				{
-					server.second->run_frame();
+					std::unique_lock<std::mutex> lock(message_mutex);
+					message_condition.wait(lock, []()
+					{
+						return message_pending || terminate;
+					});
+
+					message_pending = false;
 				}
 
-				lock.unlock();
+				if (terminate) break;
+
+				std::vector<std::shared_ptr<service_server>> active_servers;
+
+				{
+					std::lock_guard<std::recursive_mutex> _(server_mutex);
+					active_servers.reserve(servers.size());
 
-				std::this_thread::sleep_for(50ms);
+					for (const auto& server : servers)
+					{
+						active_servers.push_back(server.second);
+					}
+				}
+
+				for (const auto& server : active_servers)
+				{
+					server->run_frame();
+				}
 			}
 		}
 
@@ -273,7 +316,7 @@ namespace demonware
 					do
 					{
 						result = server->recv(buf, len);
-						if (blocking && result < 0) std::this_thread::sleep_for(1ms);
+						if (blocking && result < 0) server->wait_for_data(100ms);
 					}
 					while (blocking && result < 0);
 
@@ -301,7 +344,6 @@ namespace demonware
 
 			int WINAPI close_socket(const SOCKET s)
 			{
-				remove_blocking_socket(s);
 				unlink_socket(s);
 				return closesocket(s);
 			}
@@ -408,16 +450,35 @@ namespace demonware
 	{
 		std::lock_guard<std::recursive_mutex> _(server_mutex);
 		datagram_packets[s].push({std::string(LPSTR(to), size_t(tolen)), data});
+		tracked_sockets.set_flags(s, socket_registry::datagram);
+	}
+
+	void wake_server_thread()
+	{
+		{
+			std::lock_guard<std::mutex> _(message_mutex);
+			message_pending = true;
+		}
+
+		message_condition.notify_one();
 	}
 
-	uint8_t* get_key(const bool encrypt)
+	service_dispatcher* get_service_dispatcher()
 	{
-		return encrypt ? encryption_key_ : decryption_key_;
+		return dispatcher.get();
 	}
 
-	void set_key(const bool encrypt, uint8_t* key)
+	void get_key(const bool encrypt, uint8_t* key)
+	{
+		std::lock_guard<std::mutex> _(key_mutex);
+		std::memcpy(key, encrypt ? encryption_key_ : decryption_key_, sizeof encryption_key_);
+	}
+
+	void set_key(const bool encrypt, const uint8_t* key)
 	{
 		static_assert(sizeof encryption_key_ == sizeof decryption_key_);
+
+		std::lock_guard<std::mutex> _(key_mutex);
 		std::memcpy(encrypt ? encryption_key_ : decryption_key_, key, sizeof encryption_key_);
 	}
 
@@ -426,6 +487,8 @@ namespace demonware
 	public:
 		void post_load() override
 		{
+			dispatcher = std::make_unique<service_dispatcher>(std::clamp(std::thread::hardware_concurrency() / 2, 2u, 4u));
+
 			startup_dw();
 
 			message_thread = utils::thread::create_named_thread("Demonware", server_thread);
@@ -443,23 +506,59 @@ namespace demonware
 		void post_unpack() override
 		{
 			utils::hook::jump(SELECT_VALUE(0x140602230, 0x1406F54D0), bd_logger_stub);
+
+			command::add("dw_socket_stats", []()
+			{
+				const auto stats = tracked_sockets.get_statistics();
+				console::info("Tracked sockets: %llu\n", stats.entries);
+				console::info("Untracked lookups: %llu\n", stats.untracked_lookups);
+				console::info("Tracked lookups: %llu\n", stats.tracked_lookups);
+				console::info("Lock contentions: %llu\n", server_mutex_contentions.load(std::memory_order_relaxed));
+			});
+
+			command::add("dw_service_stats", []()
+			{
+				std::lock_guard _(server_mutex);
+
+				for (const auto& server : servers | std::views::values)
+				{
+					console::info("%s:\n", server->get_name().data());
+
+					for (const auto& stats : server->get_service_statistics())
+					{
+						if (!stats.calls)
+						{
+							continue;
+						}
+
+						console::info("  service %3u: %6llu calls, avg %8.1f us, max %8llu us, avg wait %8.1f us\n",
+						              stats.type, stats.calls, static_cast<double>(stats.total_us) / stats.calls,
+						              stats.max_us, static_cast<double>(stats.total_wait_us) / stats.calls);
+					}
+				}
+			});
 		}
 
 		void pre_destroy() override
 		{
-			std::lock_guard _(server_mutex);
-
 			terminate = true;
+			wake_server_thread();
+
 			if (message_thread.joinable())
 			{
 				message_thread.join();
 			}
 
+			// Workers reference the servers, stop them before the servers go away
+			dispatcher.reset();
+
+			std::lock_guard _(server_mutex);
+
 			servers.clear();
 			stun_servers.clear();
 			socket_links.clear();
-			blocking_sockets.clear();
 			datagram_packets.clear();
+			tracked_sockets.clear();
 		}
 	};
 }
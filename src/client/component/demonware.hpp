@@ -2,8 +2,13 @@
 
 namespace demonware
 {
+	class service_dispatcher;
+
 	void send_datagram_packet(SOCKET s, const std::string& data, const sockaddr* to, int tolen);
+	void wake_server_thread();
+	service_dispatcher* get_service_dispatcher();
 
-	uint8_t* get_key(const bool encrypt);
-	void set_key(bool encrypt, uint8_t* key);
+	// Keys are copied in and out under a lock, service calls run on several threads
+	void get_key(bool encrypt, uint8_t* key);
+	void set_key(bool encrypt, const uint8_t* key);
 }
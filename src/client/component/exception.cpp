@@ -198,7 +198,7 @@ namespace exception
 			utils::compression::zip::archive zip_file{};
 			zip_file.add("crash.dmp", create_minidump(exceptioninfo));
 			zip_file.add("info.txt", generate_crash_info(exceptioninfo));
-			zip_file.write(crash_name, "IW6x Crash Dump");
+			zip_file.write(crash_name, "IW6x Crash Dump", utils::compression::zlib::default_compression);
 		}
 
 		bool is_harmless_error(const LPEXCEPTION_POINTERS exceptioninfo)
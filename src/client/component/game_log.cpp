@@ -13,11 +13,174 @@
 #include <utils/hook.hpp>
 #include <utils/io.hpp>
 #include <utils/string.hpp>
+#include <utils/thread.hpp>
 
 namespace game_log
 {
 	namespace
 	{
+		constexpr size_t flush_threshold = 64 * 1024;
+		constexpr size_t max_pending_size = 1024 * 1024;
+		constexpr auto flush_interval = 1s;
+
+		game::dvar_t* g_log_max_size = nullptr;
+		game::dvar_t* g_log_rotate_per_map = nullptr;
+
+		volatile bool kill = false;
+		std::thread writer_thread;
+
+		struct
+		{
+			std::mutex mutex;
+			std::condition_variable condition;
+			std::string path;
+			std::string pending;
+		} log_queue;
+
+		struct
+		{
+			std::mutex mutex;
+			std::ofstream stream;
+			std::string path;
+			bool rotate = false;
+		} log_file;
+
+		void rotate_log_file()
+		{
+			log_file.stream.close();
+
+			const auto target = utils::string::va("%s.%lld", log_file.path.data(), static_cast<long long>(std::time(nullptr)));
+			utils::io::move_file(log_file.path, target);
+		}
+
+		bool open_log_file(const std::string& path)
+		{
+			if (log_file.stream.is_open() && log_file.path == path)
+			{
+				return true;
+			}
+
+			log_file.stream.close();
+			log_file.path = path;
+
+			const auto pos = path.find_last_of("/\\");
+			if (pos != std::string::npos)
+			{
+				utils::io::create_directory(path.substr(0, pos));
+			}
+
+			log_file.stream.open(path, std::ios::binary | std::ofstream::out | std::ofstream::app);
+			return log_file.stream.is_open();
+		}
+
+		void write_log_data(const std::string& path, const std::string& data)
+		{
+			if (path.empty() || data.empty())
+			{
+				return;
+			}
+
+			std::lock_guard<std::mutex> _(log_file.mutex);
+
+			if (log_file.rotate && log_file.path == path && log_file.stream.is_open())
+			{
+				rotate_log_file();
+			}
+
+			log_file.rotate = false;
+
+			if (!open_log_file(path))
+			{
+				return;
+			}
+
+			log_file.stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+			log_file.stream.flush();
+
+			const auto max_size = g_log_max_size ? g_log_max_size->current.integer : 0;
+			if (max_size > 0 && log_file.stream.tellp() >= static_cast<std::streamoff>(max_size) * 1024)
+			{
+				rotate_log_file();
+			}
+		}
+
+		// Held from taking the pending buffer until it is written, so chunks reach the file in order
+		// and a flush only returns once everything queued before it is on disk
+		std::mutex flush_mutex;
+
+		void flush_pending()
+		{
+			std::string path{};
+			std::string data{};
+
+			{
+				std::lock_guard<std::mutex> _(log_queue.mutex);
+				path = log_queue.path;
+				data.swap(log_queue.pending);
+			}
+
+			write_log_data(path, data);
+		}
+
+		void flush()
+		{
+			std::lock_guard<std::mutex> _(flush_mutex);
+			flush_pending();
+		}
+
+		void log_writer()
+		{
+			while (!kill)
+			{
+				{
+					std::unique_lock<std::mutex> lock(log_queue.mutex);
+					log_queue.condition.wait_for(lock, flush_interval, []()
+					{
+						return kill || log_queue.pending.size() >= flush_threshold;
+					});
+				}
+
+				flush();
+			}
+		}
+
+		void queue_log_data(const char* path, const std::string_view data)
+		{
+			std::unique_lock<std::mutex> lock(log_queue.mutex);
+
+			if (log_queue.path != path)
+			{
+				// Take the flush lock first to keep the lock order, then write out what belongs to the old path
+				lock.unlock();
+				std::lock_guard<std::mutex> _(flush_mutex);
+				lock.lock();
+
+				std::string previous_path = log_queue.path;
+				std::string previous_data{};
+				previous_data.swap(log_queue.pending);
+
+				log_queue.path = path;
+				log_queue.pending.append(data);
+				lock.unlock();
+
+				write_log_data(previous_path, previous_data);
+				return;
+			}
+
+			log_queue.pending.append(data);
+
+			if (log_queue.pending.size() >= max_pending_size)
+			{
+				// Writer can't keep up, apply backpressure instead of dropping lines
+				lock.unlock();
+				flush();
+			}
+			else if (log_queue.pending.size() >= flush_threshold)
+			{
+				log_queue.condition.notify_one();
+			}
+		}
+
 		void gscr_log_print()
 		{
 			char buf[1024]{};
@@ -59,12 +222,12 @@ namespace game_log
 		va_end(ap);
 
 		const auto time = *game::level_time / 1000;
-		utils::io::write_file(log, utils::string::va("%3i:%i%i %s",
+		queue_log_data(log, utils::string::va("%3i:%i%i %s",
 			time / 60,
 			time % 60 / 10,
 			time % 60 % 10,
 			buffer
-		), true);
+		));
 	}
 
 	class component final : public component_interface
@@ -82,8 +245,14 @@ namespace game_log
 			scheduler::once([]
 			{
 				dvars::g_log = game::Dvar_RegisterString("g_log", "logs/games_mp.log", game::DVAR_FLAG_NONE, "Log file name");
+				g_log_max_size = game::Dvar_RegisterInt("g_logMaxSize", 0, 0, 1024 * 1024, game::DVAR_FLAG_NONE,
+				                                        "Rotate the log file once it exceeds this size in KB (0 to disable)");
+				g_log_rotate_per_map = game::Dvar_RegisterBool("g_logRotatePerMap", false, game::DVAR_FLAG_NONE,
+				                                               "Start a new log file for every map");
 			}, scheduler::pipeline::main);
 
+			writer_thread = utils::thread::create_named_thread("Game Log", log_writer);
+
 			scripting::on_init([]
 			{
 				console::info("------- Game Initialization -------\n");
@@ -98,6 +267,17 @@ namespace game_log
 				}
 
 				console::info("Logging to disk: '%s'.\n", log);
+
+				if (g_log_rotate_per_map && g_log_rotate_per_map->current.enabled)
+				{
+					// Keep the writer out until the flag is set, so the previous map's lines stay in the old file
+					std::lock_guard<std::mutex> _(flush_mutex);
+					flush_pending();
+
+					std::lock_guard<std::mutex> file_lock(log_file.mutex);
+					log_file.rotate = true;
+				}
+
 				g_log_printf("------------------------------------------------------------\n");
 				g_log_printf("InitGame\n");
 			});
@@ -108,8 +288,26 @@ namespace game_log
 
 				g_log_printf("ShutdownGame:\n");
 				g_log_printf("------------------------------------------------------------\n");
+				flush();
 			});
 		}
+
+		void pre_destroy() override
+		{
+			{
+				std::lock_guard<std::mutex> _(log_queue.mutex);
+				kill = true;
+			}
+
+			log_queue.condition.notify_one();
+
+			if (writer_thread.joinable())
+			{
+				writer_thread.join();
+			}
+
+			flush();
+		}
 	};
 }
 
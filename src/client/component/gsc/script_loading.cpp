@@ -4,6 +4,8 @@
 
 #include <utils/io.hpp>
 #include <utils/hook.hpp>
+#include <utils/cryptography.hpp>
+#include <utils/string.hpp>
 
 #include "component/filesystem.hpp"
 #include "component/console.hpp"
@@ -12,6 +14,8 @@
 
 #include "script_loading.hpp"
 
+#include "version.hpp"
+
 #include <xsk/gsc/types.hpp>
 #include <xsk/gsc/interfaces/compiler.hpp>
 #include <xsk/gsc/interfaces/decompiler.hpp>
@@ -35,6 +39,30 @@ namespace gsc
 
 		std::unordered_map<std::string, game::ScriptFile*> loaded_scripts;
 
+		// Bump when the layout of cache files changes, the client version covers the compiler itself
+		constexpr std::uint32_t script_cache_version = 1;
+		const std::string script_cache_folder = "iw6x/cache/gsc/";
+
+		struct compiled_script
+		{
+			std::string source_hash;
+			std::vector<std::pair<std::string, std::string>> include_hashes;
+			std::string stack;
+			std::string bytecode;
+		};
+
+		// Survive map changes, entries are validated against the current sources on every use
+		std::unordered_map<std::string, compiled_script> compiled_scripts;
+		std::unordered_map<std::string, std::vector<std::uint8_t>> decompiled_includes;
+
+		struct script_cache_statistics
+		{
+			size_t hits;
+			size_t misses;
+		};
+
+		script_cache_statistics script_cache_stats{};
+
 		void clear()
 		{
 			main_handles.clear();
@@ -76,22 +104,226 @@ namespace gsc
 			return false;
 		}
 
-		game::ScriptFile* load_custom_script(const char* file_name, const std::string& real_name)
+		std::string get_script_file_name(const std::string& name)
 		{
-			if (const auto itr = loaded_scripts.find(real_name); itr != loaded_scripts.end())
+			const auto id = xsk::gsc::iw6::resolver::token_id(name);
+			if (!id)
 			{
-				return itr->second;
+				return name;
 			}
 
-			std::string source_buffer{};
-			if (!read_script_file(real_name + ".gsc", &source_buffer))
+			return std::to_string(id);
+		}
+
+		std::string hash_script_file(const game::ScriptFile* script_file)
+		{
+			std::string data{};
+			data.append(script_file->buffer, script_file->len);
+			data.append(reinterpret_cast<const char*>(script_file->bytecode), script_file->bytecodeLen);
+
+			return utils::cryptography::sha1::compute(data, true);
+		}
+
+		// Includes come either from a source file or from a stock scriptfile that gets decompiled,
+		// the hash covers whichever of the two would be used
+		std::optional<std::string> hash_include(const std::string& include_name, std::string* source = nullptr,
+		                                        const game::ScriptFile** script_file = nullptr)
+		{
+			std::string file_buffer;
+			if (read_script_file(include_name + ".gsc", &file_buffer) && !file_buffer.empty())
+			{
+				auto hash = utils::cryptography::sha1::compute(file_buffer, true);
+				if (source)
+				{
+					*source = std::move(file_buffer);
+				}
+
+				return hash;
+			}
+
+			const auto name = get_script_file_name(include_name);
+			if (!game::DB_XAssetExists(game::ASSET_TYPE_SCRIPTFILE, name.data()))
+			{
+				return {};
+			}
+
+			const auto* asset = game::DB_FindXAssetHeader(game::ASSET_TYPE_SCRIPTFILE, name.data(), false).scriptfile;
+			if (!asset)
+			{
+				return {};
+			}
+
+			if (script_file)
+			{
+				*script_file = asset;
+			}
+
+			return hash_script_file(asset);
+		}
+
+		// The resolver keeps include files for the whole level, so the compiler doesn't ask for every include of
+		// every script. The include directives of the source are the dependencies instead.
+		std::vector<std::pair<std::string, std::string>> hash_includes(const std::string& source)
+		{
+			static const std::regex include_expression(R"(#include\s+([\w\\/]+)\s*;)");
+
+			std::vector<std::pair<std::string, std::string>> includes{};
+
+			for (auto i = std::sregex_iterator(source.begin(), source.end(), include_expression); i != std::sregex_iterator(); ++i)
+			{
+				auto name = utils::string::to_lower(utils::string::replace((*i)[1].str(), "\\", "/"));
+				auto hash = hash_include(name).value_or("");
+				includes.emplace_back(std::move(name), std::move(hash));
+			}
+
+			return includes;
+		}
+
+		void write_cache_blob(std::string& buffer, const std::string_view data)
+		{
+			const auto size = static_cast<std::uint32_t>(data.size());
+			buffer.append(reinterpret_cast<const char*>(&size), sizeof(size));
+			buffer.append(data);
+		}
+
+		bool read_cache_blob(std::string_view& buffer, std::string* data)
+		{
+			std::uint32_t size{};
+			if (buffer.size() < sizeof(size))
+			{
+				return false;
+			}
+
+			std::memcpy(&size, buffer.data(), sizeof(size));
+			buffer.remove_prefix(sizeof(size));
+
+			if (buffer.size() < size)
+			{
+				return false;
+			}
+
+			data->assign(buffer.data(), size);
+			buffer.remove_prefix(size);
+			return true;
+		}
+
+		std::string get_cache_path(const std::string& real_name)
+		{
+			return script_cache_folder + real_name + ".bin";
+		}
+
+		std::string get_cache_header()
+		{
+			return std::format("IW6x GSC cache {} ({})", script_cache_version, VERSION);
+		}
+
+		std::optional<compiled_script> read_cache_file(const std::string& real_name)
+		{
+			std::string data{};
+			if (!utils::io::read_file(get_cache_path(real_name), &data))
+			{
+				return {};
+			}
+
+			std::string_view buffer = data;
+
+			std::string header{};
+			if (!read_cache_blob(buffer, &header) || header != get_cache_header())
+			{
+				return {};
+			}
+
+			compiled_script script{};
+			std::string include_count{};
+
+			if (!read_cache_blob(buffer, &script.source_hash) || !read_cache_blob(buffer, &include_count) ||
+				include_count.size() != sizeof(std::uint32_t))
+			{
+				return {};
+			}
+
+			std::uint32_t count{};
+			std::memcpy(&count, include_count.data(), sizeof(count));
+
+			for (std::uint32_t i = 0; i < count; ++i)
+			{
+				std::string name{}, hash{};
+				if (!read_cache_blob(buffer, &name) || !read_cache_blob(buffer, &hash))
+				{
+					return {};
+				}
+
+				script.include_hashes.emplace_back(std::move(name), std::move(hash));
+			}
+
+			if (!read_cache_blob(buffer, &script.stack) || !read_cache_blob(buffer, &script.bytecode))
+			{
+				return {};
+			}
+
+			return {std::move(script)};
+		}
+
+		void write_cache_file(const std::string& real_name, const compiled_script& script)
+		{
+			std::string data{};
+			write_cache_blob(data, get_cache_header());
+			write_cache_blob(data, script.source_hash);
+
+			const auto count = static_cast<std::uint32_t>(script.include_hashes.size());
+			write_cache_blob(data, {reinterpret_cast<const char*>(&count), sizeof(count)});
+
+			for (const auto& [name, hash] : script.include_hashes)
+			{
+				write_cache_blob(data, name);
+				write_cache_blob(data, hash);
+			}
+
+			write_cache_blob(data, script.stack);
+			write_cache_blob(data, script.bytecode);
+
+			utils::io::write_file(get_cache_path(real_name), data);
+		}
+
+		bool is_cache_valid(const compiled_script& script, const std::string& source_hash)
+		{
+			if (script.source_hash != source_hash)
+			{
+				return false;
+			}
+
+			return std::ranges::all_of(script.include_hashes, [](const std::pair<std::string, std::string>& include)
+			{
+				return hash_include(include.first).value_or("") == include.second;
+			});
+		}
+
+		const compiled_script* find_compiled_script(const std::string& real_name, const std::string& source_hash)
+		{
+			if (const auto itr = compiled_scripts.find(real_name); itr != compiled_scripts.end())
+			{
+				return is_cache_valid(itr->second, source_hash) ? &itr->second : nullptr;
+			}
+
+			auto script = read_cache_file(real_name);
+			if (!script || !is_cache_valid(*script, source_hash))
 			{
 				return nullptr;
 			}
 
+			return &(compiled_scripts[real_name] = std::move(*script));
+		}
+
+		const compiled_script* compile_script(const std::string& real_name, const std::string& source_buffer,
+		                                      const std::string& source_hash)
+		{
 			std::vector<std::uint8_t> data;
 			data.assign(source_buffer.begin(), source_buffer.end());
 
+			compiled_script script{};
+			script.source_hash = source_hash;
+			script.include_hashes = hash_includes(source_buffer);
+
 			try
 			{
 				compiler->compile(real_name, data);
@@ -118,13 +350,54 @@ namespace gsc
 				return nullptr;
 			}
 
+			const auto stack = assembler->output_stack();
+			script.stack.assign(stack.begin(), stack.end());
+
+			const auto bytecode = assembler->output_script();
+			script.bytecode.assign(bytecode.begin(), bytecode.end());
+
+			write_cache_file(real_name, script);
+			return &(compiled_scripts[real_name] = std::move(script));
+		}
+
+		game::ScriptFile* load_custom_script(const char* file_name, const std::string& real_name)
+		{
+			if (const auto itr = loaded_scripts.find(real_name); itr != loaded_scripts.end())
+			{
+				return itr->second;
+			}
+
+			std::string source_buffer{};
+			if (!read_script_file(real_name + ".gsc", &source_buffer))
+			{
+				return nullptr;
+			}
+
+			const auto source_hash = utils::cryptography::sha1::compute(source_buffer, true);
+
+			const auto* compiled = find_compiled_script(real_name, source_hash);
+			if (compiled)
+			{
+				++script_cache_stats.hits;
+			}
+			else
+			{
+				++script_cache_stats.misses;
+
+				compiled = compile_script(real_name, source_buffer, source_hash);
+				if (!compiled)
+				{
+					return nullptr;
+				}
+			}
+
 			const auto script_file_ptr = static_cast<game::ScriptFile*>(game::Hunk_AllocateTempMemoryHighInternal(sizeof(game::ScriptFile)));
 			script_file_ptr->name = file_name;
 
-			const auto stack = assembler->output_stack();
+			const auto& stack = compiled->stack;
 			script_file_ptr->len = static_cast<int>(stack.size());
 
-			const auto script = assembler->output_script();
+			const auto& script = compiled->bytecode;
 			script_file_ptr->bytecodeLen = static_cast<int>(script.size());
 
 			const auto stack_size = static_cast<std::uint32_t>(stack.size() + 1);
@@ -143,25 +416,9 @@ namespace gsc
 			return script_file_ptr;
 		}
 
-		std::string get_script_file_name(const std::string& name)
+		std::vector<std::uint8_t> decompile_script_file(const game::ScriptFile* script_file, const std::string& name,
+		                                                const std::string& real_name)
 		{
-			const auto id = xsk::gsc::iw6::resolver::token_id(name);
-			if (!id)
-			{
-				return name;
-			}
-
-			return std::to_string(id);
-		}
-
-		std::vector<std::uint8_t> decompile_script_file(const std::string& name, const std::string& real_name)
-		{
-			const auto* script_file = game::DB_FindXAssetHeader(game::ASSET_TYPE_SCRIPTFILE, name.data(), false).scriptfile;
-			if (!script_file)
-			{
-				throw std::runtime_error(std::format("Could not load scriptfile '{}'", real_name));
-			}
-
 			console::info("Decompiling scriptfile '%s'\n", real_name.data());
 
 			std::vector<std::uint8_t> stack{script_file->buffer, script_file->buffer + script_file->len};
@@ -236,6 +493,18 @@ namespace gsc
 
 		void gscr_load_game_type_script_stub()
 		{
+			script_cache_stats = {};
+
+			const auto _ = gsl::finally([]
+			{
+				const auto total = script_cache_stats.hits + script_cache_stats.misses;
+				if (total)
+				{
+					console::info("GSC cache: %zu hits, %zu misses (%.0f%% hit rate)\n", script_cache_stats.hits,
+					              script_cache_stats.misses, 100.0 * static_cast<double>(script_cache_stats.hits) / total);
+				}
+			});
+
 			utils::hook::invoke<void>(0x1403CCB10);
 
 			clear();
@@ -332,15 +601,24 @@ namespace gsc
 				const auto real_name = include_name + ".gsc";
 
 				std::string file_buffer;
-				if (!read_script_file(real_name, &file_buffer) || file_buffer.empty())
+				const game::ScriptFile* script_file = nullptr;
+
+				const auto hash = hash_include(include_name, &file_buffer, &script_file);
+				if (!hash)
 				{
-					const auto name = get_script_file_name(include_name);
-					if (game::DB_XAssetExists(game::ASSET_TYPE_SCRIPTFILE, name.data()))
+					throw std::runtime_error(std::format("Could not load gsc file '{}'", real_name));
+				}
+
+				if (script_file)
+				{
+					// Stock scriptfiles only change with the fastfiles, so their decompiled source is kept by hash
+					auto& decompiled = decompiled_includes[*hash];
+					if (decompiled.empty())
 					{
-						return decompile_script_file(name, real_name);
+						decompiled = decompile_script_file(script_file, get_script_file_name(include_name), real_name);
 					}
 
-					throw std::runtime_error(std::format("Could not load gsc file '{}'", real_name));
+					return decompiled;
 				}
 
 				std::vector<std::uint8_t> result;
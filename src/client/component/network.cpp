@@ -152,10 +152,10 @@ namespace network
 		{
 			if (a.port)
 			{
-				return utils::string::va("%u.%u.%u.%u:%u", a.ip[0], a.ip[1], a.ip[2], a.ip[3], htons(a.port));
+				return utils::string::va_format("{}.{}.{}.{}:{}", a.ip[0], a.ip[1], a.ip[2], a.ip[3], htons(a.port));
 			}
 
-			return utils::string::va("%u.%u.%u.%u", a.ip[0], a.ip[1], a.ip[2], a.ip[3]);
+			return utils::string::va_format("{}.{}.{}.{}", a.ip[0], a.ip[1], a.ip[2], a.ip[3]);
 		}
 
 		return "bad";
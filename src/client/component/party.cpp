@@ -490,7 +490,7 @@ namespace party
 
 			network::on("infoResponse", [](const game::netadr_s& target, const std::string& data)
 			{
-				const utils::info_string info(data);
+				const utils::info_string_view info(data);
 				server_list::handle_info_response(target, info);
 
 				if (connect_state.host != target)
@@ -504,14 +504,14 @@ namespace party
 					return;
 				}
 
-				const auto mapname = info.get("mapname");
+				const std::string mapname{info.get("mapname")};
 				if (mapname.empty())
 				{
 					console::info("Invalid map.\n");
 					return;
 				}
 
-				const auto gametype = info.get("gametype");
+				const std::string gametype{info.get("gametype")};
 				if (gametype.empty())
 				{
 					console::info("Invalid gametype.\n");
@@ -529,7 +529,7 @@ namespace party
 
 				try
 				{
-					sv_maxclients = std::stoi(info.get("sv_maxclients"));
+					sv_maxclients = std::stoi(std::string{info.get("sv_maxclients")});
 				}
 				catch ([[maybe_unused]] const std::exception& ex)
 				{
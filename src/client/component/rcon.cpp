@@ -56,20 +56,19 @@ namespace rcon
 
 				if (client->header.state > game::CS_FREE && self && self->client)
 				{
-					buffer.append(utils::string::va("%3i %5i %3s %s %32s %16s %21s %5i\n",
-					                                i,
-					                                self->client->sess.scores.score,
-					                                game::SV_BotIsBot(i) ? "Yes" : "No",
-					                                (client->header.state == game::CS_RECONNECTING)
-						                                ? "CNCT"
-						                                : (client->header.state == game::CS_ZOMBIE)
-						                                ? "ZMBI"
-						                                : utils::string::va("%4i", client->ping),
-					                                game::SV_GetGuid(i),
-					                                clean_name,
-					                                network::net_adr_to_string(client->header.netchan.remoteAddress),
-					                                client->header.netchan.remoteAddress.port)
-					);
+					std::format_to(std::back_inserter(buffer), "{:3} {:5} {:>3} {} {:>32} {:>16} {:>21} {:5}\n",
+					               i,
+					               self->client->sess.scores.score,
+					               game::SV_BotIsBot(i) ? "Yes" : "No",
+					               (client->header.state == game::CS_RECONNECTING)
+						               ? "CNCT"
+						               : (client->header.state == game::CS_ZOMBIE)
+						               ? "ZMBI"
+						               : utils::string::va_format("{:4}", client->ping),
+					               game::SV_GetGuid(i),
+					               static_cast<const char*>(clean_name),
+					               network::net_adr_to_string(client->header.netchan.remoteAddress),
+					               client->header.netchan.remoteAddress.port);
 				}
 			}
 
@@ -1,8 +1,11 @@
 #include <std_include.hpp>
 #include "loader/component_loader.hpp"
 #include "scheduler.hpp"
+#include "command.hpp"
+#include "console.hpp"
 #include "game/game.hpp"
 #include <utils/hook.hpp>
+#include <utils/io.hpp>
 #include <utils/thread.hpp>
 #include <utils/concurrency.hpp>
 
@@ -10,15 +13,252 @@ namespace scheduler
 {
 	namespace
 	{
+		constexpr size_t histogram_buckets = 24;
+		constexpr size_t max_trace_events = 200'000;
+
+		const char* pipeline_names[pipeline::count] = {"async", "renderer", "server", "main"};
+
+		struct task_profile
+		{
+			std::string name{};
+			pipeline type{};
+			std::atomic<uint64_t> calls{0};
+			std::atomic<uint64_t> total_us{0};
+			std::atomic<uint64_t> max_us{0};
+
+			// Bucket i counts calls that took less than 2^i microseconds
+			std::array<std::atomic<uint64_t>, histogram_buckets> histogram{};
+		};
+
+		struct trace_event
+		{
+			const task_profile* profile;
+			uint64_t start_us;
+			uint64_t duration_us;
+		};
+
+		std::atomic_bool profiling_enabled = false;
+		const auto profiling_epoch = std::chrono::high_resolution_clock::now();
+		utils::concurrency::container<std::map<std::string, std::unique_ptr<task_profile>>> task_profiles;
+		utils::concurrency::container<std::deque<trace_event>> trace_events;
+
+		task_profile* get_task_profile(const pipeline type, const std::source_location& location)
+		{
+			std::string_view file = location.file_name();
+			const auto pos = file.find_last_of("/\\");
+			if (pos != std::string_view::npos)
+			{
+				file.remove_prefix(pos + 1);
+			}
+
+			auto name = std::format("{}:{}", file, location.line());
+			auto key = std::format("{}/{}", pipeline_names[type], name);
+
+			return task_profiles.access<task_profile*>([&](std::map<std::string, std::unique_ptr<task_profile>>& profiles)
+			{
+				auto& profile = profiles[std::move(key)];
+				if (!profile)
+				{
+					profile = std::make_unique<task_profile>();
+					profile->name = std::move(name);
+					profile->type = type;
+				}
+
+				return profile.get();
+			});
+		}
+
+		void record_task(task_profile& profile, const std::chrono::high_resolution_clock::time_point start,
+		                 const std::chrono::high_resolution_clock::time_point end)
+		{
+			const auto duration = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+
+			profile.calls.fetch_add(1, std::memory_order_relaxed);
+			profile.total_us.fetch_add(duration, std::memory_order_relaxed);
+
+			auto max = profile.max_us.load(std::memory_order_relaxed);
+			while (duration > max && !profile.max_us.compare_exchange_weak(max, duration, std::memory_order_relaxed))
+			{
+			}
+
+			size_t bucket = 0;
+			while (bucket + 1 < histogram_buckets && duration >= (1ull << bucket))
+			{
+				++bucket;
+			}
+
+			profile.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+
+			const auto start_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(start - profiling_epoch).count());
+			trace_events.access([&](std::deque<trace_event>& events)
+			{
+				if (events.size() >= max_trace_events)
+				{
+					events.pop_front();
+				}
+
+				events.push_back({&profile, start_us, duration});
+			});
+		}
+
 		struct task
 		{
 			std::function<bool()> handler{};
 			std::chrono::milliseconds interval{};
 			std::chrono::high_resolution_clock::time_point last_call{};
+			uint64_t sequence{};
+			pipeline type{};
+
+			// Resolved on the first profiled run, scheduling a task stays free of string work
+			std::source_location location{};
+			task_profile* profile{};
 		};
 
+		bool run_task(task& task)
+		{
+			if (!profiling_enabled)
+			{
+				return task.handler();
+			}
+
+			if (!task.profile)
+			{
+				task.profile = get_task_profile(task.type, task.location);
+			}
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			const auto result = task.handler();
+			record_task(*task.profile, start, std::chrono::high_resolution_clock::now());
+
+			return result;
+		}
+
+		uint64_t get_histogram_percentile(const task_profile& profile, const uint64_t calls, const uint64_t percentile)
+		{
+			const auto target = std::max(1ull, (calls * percentile + 99) / 100);
+
+			uint64_t count = 0;
+			for (size_t i = 0; i < histogram_buckets; ++i)
+			{
+				count += profile.histogram[i].load(std::memory_order_relaxed);
+				if (count >= target)
+				{
+					return 1ull << i;
+				}
+			}
+
+			return 1ull << (histogram_buckets - 1);
+		}
+
+		void print_task_profiles()
+		{
+			std::vector<const task_profile*> profiles{};
+
+			task_profiles.access([&](const std::map<std::string, std::unique_ptr<task_profile>>& entries)
+			{
+				for (const auto& [_, profile] : entries)
+				{
+					if (profile->calls.load(std::memory_order_relaxed))
+					{
+						profiles.push_back(profile.get());
+					}
+				}
+			});
+
+			std::ranges::sort(profiles, std::greater{}, [](const task_profile* profile)
+			{
+				return profile->total_us.load(std::memory_order_relaxed);
+			});
+
+			console::info("================================ SCHEDULER PROFILE ================================\n");
+			console::info("%-9s %-32s %10s %12s %10s %10s %10s\n", "pipeline", "source", "calls", "total (us)", "avg (us)", "p99 (us)", "max (us)");
+
+			for (const auto* profile : profiles)
+			{
+				const auto calls = profile->calls.load(std::memory_order_relaxed);
+				const auto total = profile->total_us.load(std::memory_order_relaxed);
+
+				console::info("%-9s %-32s %10llu %12llu %10llu %10llu %10llu\n", pipeline_names[profile->type],
+				              profile->name.data(), calls, total, total / calls,
+				              get_histogram_percentile(*profile, calls, 99),
+				              profile->max_us.load(std::memory_order_relaxed));
+			}
+
+			console::info("================================ END SCHEDULER PROFILE ============================\n");
+		}
+
+		void reset_task_profiles()
+		{
+			task_profiles.access([](const std::map<std::string, std::unique_ptr<task_profile>>& entries)
+			{
+				for (const auto& [_, profile] : entries)
+				{
+					profile->calls = 0;
+					profile->total_us = 0;
+					profile->max_us = 0;
+
+					for (auto& bucket : profile->histogram)
+					{
+						bucket = 0;
+					}
+				}
+			});
+
+			trace_events.access([](std::deque<trace_event>& events)
+			{
+				events.clear();
+			});
+		}
+
+		bool export_chrome_trace(const std::string& file)
+		{
+			std::string trace = "{\"traceEvents\":[";
+
+			for (auto i = 0; i < pipeline::count; ++i)
+			{
+				trace.append(std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}},",
+				                         i, pipeline_names[i]));
+			}
+
+			trace_events.access([&](const std::deque<trace_event>& events)
+			{
+				for (const auto& event : events)
+				{
+					// Source names are file:line, nothing in them needs escaping
+					trace.append(std::format("{{\"name\":\"{}\",\"cat\":\"scheduler\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":0,\"tid\":{}}},",
+					                         event.profile->name, event.start_us, event.duration_us,
+					                         static_cast<int>(event.profile->type)));
+				}
+			});
+
+			trace.pop_back();
+			trace.append("]}");
+
+			return utils::io::write_file(file, trace);
+		}
+
 		using task_list = std::vector<task>;
 
+		// Tasks without an interval run every frame, the rest wait in a min-heap ordered by their next deadline.
+		// Within a frame every task that runs does so in insertion order.
+		struct task_queue
+		{
+			task_list frame_tasks;
+			task_list timed_tasks;
+		};
+
+		bool is_later(const task& a, const task& b)
+		{
+			const auto a_deadline = a.last_call + a.interval;
+			const auto b_deadline = b.last_call + b.interval;
+			if (a_deadline == b_deadline)
+			{
+				return a.sequence > b.sequence;
+			}
+
+			return a_deadline > b_deadline;
+		}
+
 		class task_pipeline
 		{
 		public:
@@ -32,47 +272,92 @@ namespace scheduler
 
 			void execute()
 			{
-				callbacks_.access([&](task_list& tasks)
+				callbacks_.access([&](task_queue& queue)
 				{
 					this->merge_callbacks();
 
-					for (auto i = tasks.begin(); i != tasks.end();)
+					const auto now = std::chrono::high_resolution_clock::now();
+
+					auto& frame_tasks = queue.frame_tasks;
+					auto& timed_tasks = queue.timed_tasks;
+
+					// Take the due timed tasks off the heap, then run them interleaved with the
+					// frame tasks in insertion order, the order one flat task list would have had
+					task_list due_tasks{};
+					while (!timed_tasks.empty() && now - timed_tasks.front().last_call >= timed_tasks.front().interval)
 					{
-						const auto now = std::chrono::high_resolution_clock::now();
-						const auto diff = now - i->last_call;
+						std::ranges::pop_heap(timed_tasks, is_later);
+						due_tasks.emplace_back(std::move(timed_tasks.back()));
+						timed_tasks.pop_back();
+					}
 
-						if (diff < i->interval)
+					std::ranges::sort(due_tasks, std::less{}, &task::sequence);
+
+					size_t kept_tasks = 0;
+					size_t next_due = 0;
+
+					const auto run_due_tasks = [&](const uint64_t until_sequence)
+					{
+						for (; next_due < due_tasks.size() && due_tasks[next_due].sequence < until_sequence; ++next_due)
 						{
-							++i;
-							continue;
+							auto& task = due_tasks[next_due];
+							task.last_call = now;
+							if (run_task(task) != cond_end)
+							{
+								timed_tasks.emplace_back(std::move(task));
+								std::ranges::push_heap(timed_tasks, is_later);
+							}
 						}
+					};
 
-						i->last_call = now;
+					for (size_t i = 0; i < frame_tasks.size(); ++i)
+					{
+						run_due_tasks(frame_tasks[i].sequence);
 
-						const auto res = i->handler();
-						if (res == cond_end)
+						frame_tasks[i].last_call = now;
+						if (run_task(frame_tasks[i]) == cond_end)
 						{
-							i = tasks.erase(i);
+							continue;
 						}
-						else
+
+						if (kept_tasks != i)
 						{
-							++i;
+							frame_tasks[kept_tasks] = std::move(frame_tasks[i]);
 						}
+
+						++kept_tasks;
 					}
+
+					frame_tasks.resize(kept_tasks);
+					run_due_tasks(std::numeric_limits<uint64_t>::max());
 				});
 			}
 
 		private:
+			uint64_t current_sequence_ = 0;
 			utils::concurrency::container<task_list> new_callbacks_;
-			utils::concurrency::container<task_list, std::recursive_mutex> callbacks_;
+			utils::concurrency::container<task_queue, std::recursive_mutex> callbacks_;
 
 			void merge_callbacks()
 			{
-				callbacks_.access([&](task_list& tasks)
+				callbacks_.access([&](task_queue& queue)
 				{
 					new_callbacks_.access([&](task_list& new_tasks)
 					{
-						tasks.insert(tasks.end(), std::move_iterator<task_list::iterator>(new_tasks.begin()), std::move_iterator<task_list::iterator>(new_tasks.end()));
+						for (auto& task : new_tasks)
+						{
+							task.sequence = ++this->current_sequence_;
+
+							if (task.interval <= 0ms)
+							{
+								queue.frame_tasks.emplace_back(std::move(task));
+								continue;
+							}
+
+							queue.timed_tasks.emplace_back(std::move(task));
+							std::ranges::push_heap(queue.timed_tasks, is_later);
+						}
+
 						new_tasks = {};
 					});
 				});
@@ -110,7 +395,7 @@ namespace scheduler
 	}
 
 	void schedule(const std::function<bool()>& callback, const pipeline type,
-		const std::chrono::milliseconds delay)
+		const std::chrono::milliseconds delay, const std::source_location& location)
 	{
 		assert(type >= 0 && type < pipeline::count);
 
@@ -118,44 +403,46 @@ namespace scheduler
 		task.handler = callback;
 		task.interval = delay;
 		task.last_call = std::chrono::high_resolution_clock::now();
+		task.type = type;
+		task.location = location;
 
 		pipelines[type].add(std::move(task));
 	}
 
 	void loop(const std::function<void()>& callback, const pipeline type,
-	          const std::chrono::milliseconds delay)
+	          const std::chrono::milliseconds delay, const std::source_location& location)
 	{
 		schedule([callback]()
 		{
 			callback();
 			return cond_continue;
-		}, type, delay);
+		}, type, delay, location);
 	}
 
 	void once(const std::function<void()>& callback, const pipeline type,
-	          const std::chrono::milliseconds delay)
+	          const std::chrono::milliseconds delay, const std::source_location& location)
 	{
 		schedule([callback]()
 		{
 			callback();
 			return cond_end;
-		}, type, delay);
+		}, type, delay, location);
 	}
 
 	void on_game_initialized(const std::function<void()>& callback, const pipeline type,
-	                         const std::chrono::milliseconds delay)
+	                         const std::chrono::milliseconds delay, const std::source_location& location)
 	{
 		schedule([=]()
 		{
 			const auto dw_init = game::environment::is_sp() || game::Live_SyncOnlineDataFlags(0) == 0;
 			if (dw_init && game::Sys_IsDatabaseReady2())
 			{
-				once(callback, type, delay);
+				once(callback, type, delay, location);
 				return cond_end;
 			}
 
 			return cond_continue;
-		}, pipeline::main);
+		}, pipeline::main, 0ms, location);
 	}
 
 	class component final : public component_interface
@@ -179,6 +466,42 @@ namespace scheduler
 
 			utils::hook::call(SELECT_VALUE(0x1403BC922, 0x140413142), scheduler::main_frame_stub);
 			utils::hook::call(SELECT_VALUE(0x1403185FD, 0x1403A0AF9), scheduler::server_frame_stub);
+
+			command::add("perf_scheduler", [](const command::params& params)
+			{
+				const std::string action = params.size() > 1 ? params[1] : "";
+
+				if (action == "start")
+				{
+					profiling_enabled = true;
+					console::info("Scheduler profiling started\n");
+				}
+				else if (action == "stop")
+				{
+					profiling_enabled = false;
+					console::info("Scheduler profiling stopped\n");
+				}
+				else if (action == "reset")
+				{
+					reset_task_profiles();
+				}
+				else if (action == "export")
+				{
+					const std::string file = params.size() > 2 ? params[2] : "scheduler_trace.json";
+					if (export_chrome_trace(file))
+					{
+						console::info("Wrote chrome trace to '%s'\n", file.data());
+					}
+				}
+				else if (action.empty() || action == "print")
+				{
+					print_task_profiles();
+				}
+				else
+				{
+					console::info("usage: perf_scheduler <start|stop|reset|print|export [file]>\n");
+				}
+			});
 		}
 
 		void pre_destroy() override
@@ -22,12 +22,17 @@ namespace scheduler
 	static const bool cond_continue = false;
 	static const bool cond_end = true;
 
+	// The source location tags the task in perf_scheduler output
 	void schedule(const std::function<bool()>& callback, pipeline type = pipeline::async,
-	              std::chrono::milliseconds delay = 0ms);
+	              std::chrono::milliseconds delay = 0ms,
+	              const std::source_location& location = std::source_location::current());
 	void loop(const std::function<void()>& callback, pipeline type = pipeline::async,
-	          std::chrono::milliseconds delay = 0ms);
+	          std::chrono::milliseconds delay = 0ms,
+	          const std::source_location& location = std::source_location::current());
 	void once(const std::function<void()>& callback, pipeline type = pipeline::async,
-	          std::chrono::milliseconds delay = 0ms);
+	          std::chrono::milliseconds delay = 0ms,
+	          const std::source_location& location = std::source_location::current());
 	void on_game_initialized(const std::function<void()>& callback, pipeline type = pipeline::async,
-	                         std::chrono::milliseconds delay = 0ms);
+	                         std::chrono::milliseconds delay = 0ms,
+	                         const std::source_location& location = std::source_location::current());
 }
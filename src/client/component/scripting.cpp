@@ -8,6 +8,8 @@
 #include "game/scripting/lua/engine.hpp"
 #include "game/scripting/execution.hpp"
 
+#include "command.hpp"
+#include "console.hpp"
 #include "scheduler.hpp"
 #include "scripting.hpp"
 
@@ -43,29 +45,54 @@ namespace scripting
 		std::vector<std::function<void(int)>> shutdown_callbacks;
 		std::vector<std::function<void()>> init_callbacks;
 
+		struct notify_statistics
+		{
+			std::atomic_uint64_t filtered;
+			std::atomic_uint64_t dispatched;
+
+			// Counts of the last full second
+			std::atomic_uint64_t filtered_per_second;
+			std::atomic_uint64_t dispatched_per_second;
+		};
+
+		notify_statistics notify_stats{};
+
 		void vm_notify_stub(const unsigned int notify_list_owner_id, const unsigned int string_value, game::VariableValue* top)
 		{
 			const auto* string = game::SL_ConvertToString(string_value);
 			if (string)
 			{
-				event e;
-				e.name = string;
-				e.entity = notify_list_owner_id;
+				const std::string_view name = string;
 
-				for (auto* value = top; value->type != game::VAR_PRECODEPOS; --value)
+				// A connecting client takes over an entity number, listeners must not see its predecessor's fields
+				if (name == "connected")
 				{
-					e.arguments.emplace_back(*value);
+					clear_entity_fields(notify_list_owner_id);
 				}
 
-				if (e.name == "connected")
+				if (lua::engine::is_notify_interesting(name))
 				{
-					clear_entity_fields(e.entity);
-				}
+					event e;
+					e.name = name;
+					e.entity = notify_list_owner_id;
+					e.top = top;
 
-				lua::engine::notify(e);
+					lua::engine::notify(e);
+					++notify_stats.dispatched;
+				}
+				else
+				{
+					++notify_stats.filtered;
+				}
 			}
 
 			vm_notify_hook.invoke<void>(notify_list_owner_id, string_value, top);
+
+			// Listeners of the deletion may still read the fields for their cleanup, drop them once everyone ran
+			if (string && std::string_view(string) == "entitydeleted")
+			{
+				clear_entity_fields(notify_list_owner_id);
+			}
 		}
 
 		void scr_load_level_stub()
@@ -84,6 +111,9 @@ namespace scripting
 		{
 			lua::engine::stop();
 
+			clear_field_cache();
+			clear_function_cache();
+
 			if (free_scripts)
 			{
 				script_function_table_sort.clear();
@@ -239,6 +269,29 @@ namespace scripting
 				lua::engine::run_frame();
 			}, scheduler::pipeline::server);
 
+			scheduler::loop([]
+			{
+				static uint64_t last_filtered = 0;
+				static uint64_t last_dispatched = 0;
+
+				const uint64_t filtered = notify_stats.filtered;
+				const uint64_t dispatched = notify_stats.dispatched;
+
+				notify_stats.filtered_per_second = filtered - last_filtered;
+				notify_stats.dispatched_per_second = dispatched - last_dispatched;
+
+				last_filtered = filtered;
+				last_dispatched = dispatched;
+			}, scheduler::pipeline::async, 1s);
+
+			command::add("lua_notify_stats", []()
+			{
+				console::info("Notifies per second: %llu filtered, %llu dispatched\n",
+				              notify_stats.filtered_per_second.load(), notify_stats.dispatched_per_second.load());
+				console::info("Notifies total: %llu filtered, %llu dispatched\n",
+				              notify_stats.filtered.load(), notify_stats.dispatched.load());
+			});
+
 			if (!game::environment::is_sp())
 			{
 				// Make some room for pre_main hook
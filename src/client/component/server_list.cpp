@@ -36,20 +36,68 @@ namespace server_list
 			game::netadr_s address;
 		};
 
+		constexpr auto query_timeout = 1000ms;
+		constexpr auto query_attempts = 3;
+
+		struct server_query
+		{
+			std::string challenge{};
+			std::chrono::steady_clock::time_point sent_at{};
+			int attempts = 0;
+		};
+
 		struct
 		{
 			game::netadr_s address{};
 			volatile bool requesting = false;
-			std::unordered_map<game::netadr_s, int> queued_servers{};
+			std::unordered_map<game::netadr_s, server_query> queued_servers{};
+			double send_budget = 0.0;
+			std::chrono::steady_clock::time_point last_budget_update{};
 		} master_state;
 
+		struct
+		{
+			size_t total = 0;
+			size_t queried = 0;
+			size_t responded = 0;
+			size_t timed_out = 0;
+			std::vector<int> round_trip_times{};
+			bool reported = true;
+		} query_stats;
+
+		game::dvar_t* sl_query_rate = nullptr;
+
 		volatile bool update_server_list = false;
 
+		using server_list_snapshot = std::vector<std::shared_ptr<const server_info>>;
+
 		std::mutex mutex;
-		std::vector<server_info> servers;
+		server_list_snapshot servers;
+		bool servers_dirty = false;
+
+		// Immutable copy of the sorted list, republished at most once per frame
+		std::atomic<std::shared_ptr<const server_list_snapshot>> snapshot;
 
 		size_t server_list_index = 0;
 
+		std::shared_ptr<const server_list_snapshot> get_snapshot()
+		{
+			auto result = snapshot.load();
+			if (!result)
+			{
+				static const auto empty_snapshot = std::make_shared<const server_list_snapshot>();
+				return empty_snapshot;
+			}
+
+			return result;
+		}
+
+		void publish_snapshot()
+		{
+			snapshot.store(std::make_shared<const server_list_snapshot>(servers));
+			servers_dirty = false;
+		}
+
 		void lui_open_menu_stub(int /*controllerIndex*/, const char* /*menu*/, int /*a3*/, int /*a4*/,
 		                        unsigned int /*a5*/)
 		{
@@ -62,7 +110,9 @@ namespace server_list
 				std::lock_guard<std::mutex> _(mutex);
 				servers.clear();
 				master_state.queued_servers.clear();
+				query_stats = {};
 				server_list_index = 0;
+				publish_snapshot();
 			}
 
 			party::reset_connect_state();
@@ -76,10 +126,10 @@ namespace server_list
 
 		void join_server(int, int, const int index)
 		{
-			std::lock_guard<std::mutex> _(mutex);
+			const auto servers = get_snapshot();
 
 			const auto i = static_cast<size_t>(index) + server_list_index;
-			if (i < servers.size())
+			if (i < servers->size())
 			{
 				static size_t last_index = 0xFFFFFFFF;
 				if (last_index != i)
@@ -88,8 +138,9 @@ namespace server_list
 				}
 				else
 				{
-					console::info("Connecting to (%d - %zu): %s\n", index, i, servers[i].host_name.data());
-					party::connect(servers[i].address);
+					const auto& server = *servers->at(i);
+					console::info("Connecting to (%d - %zu): %s\n", index, i, server.host_name.data());
+					party::connect(server.address);
 				}
 			}
 		}
@@ -111,107 +162,175 @@ namespace server_list
 
 		int ui_feeder_count()
 		{
-			std::lock_guard<std::mutex> _(mutex);
-			return static_cast<int>(servers.size() - server_list_index);
+			return static_cast<int>(get_snapshot()->size() - server_list_index);
 		}
 
 		const char* ui_feeder_item_text(int /*localClientNum*/, void* /*a2*/, void* /*a3*/, const int index,
 		                                const int column)
 		{
-			std::lock_guard<std::mutex> _(mutex);
+			const auto servers = get_snapshot();
 
 			const auto i = server_list_index + index;
 
-			if (i >= servers.size())
+			if (i >= servers->size())
 			{
 				return "";
 			}
 
+			const auto& server = *servers->at(i);
+
 			if (column == 0)
 			{
-				return utils::string::va("%s", servers[i].host_name.data());
+				return utils::string::va_format("{}", server.host_name);
 			}
 
 			if (column == 1)
 			{
-				return utils::string::va("%s", servers[i].map_name.data());
+				return utils::string::va_format("{}", server.map_name);
 			}
 
 			if (column == 2)
 			{
-				const auto client_count = servers[i].clients - servers[i].bots;
-				return utils::string::va("%d/%d [%d]", client_count, servers[i].max_clients, servers[i].bots);
+				const auto client_count = server.clients - server.bots;
+				return utils::string::va_format("{}/{} [{}]", client_count, server.max_clients, server.bots);
 			}
 
 			if (column == 3)
 			{
-				return utils::string::va("%s", servers[i].game_type.data());
+				return utils::string::va_format("{}", server.game_type);
 			}
 
 			if (column == 4)
 			{
-				return utils::string::va("%d", servers[i].ping);
+				return utils::string::va_format("{}", server.ping);
 			}
 
 			if (column == 5)
 			{
-				return utils::string::va("%d", servers[i].is_private);
+				return utils::string::va_format("{:d}", server.is_private);
 			}
 
 			return "";
 		}
 
-		void sort_serverlist()
+		bool compare_servers(const server_info& a, const server_info& b)
 		{
-			std::ranges::stable_sort(servers, [](const server_info& a, const server_info& b)
+			const auto a_players = a.clients - a.bots;
+			const auto b_players = b.clients - b.bots;
+			if (a_players == b_players)
 			{
-				const auto a_players = a.clients - a.bots;
-				const auto b_players = b.clients - b.bots;
-				if (a_players == b_players)
-				{
-					return a.ping < b.ping;
-				}
+				return a.ping < b.ping;
+			}
 
-				return a_players > b_players;
-			});
+			return a_players > b_players;
 		}
 
 		void insert_server(server_info&& server)
 		{
+			auto entry = std::make_shared<const server_info>(std::move(server));
+
 			std::lock_guard<std::mutex> _(mutex);
-			servers.emplace_back(std::move(server));
-			sort_serverlist();
+
+			// Insert after all equal entries to keep the order a stable sort would produce
+			const auto position = std::ranges::upper_bound(servers, *entry, compare_servers,
+			                                               [](const auto& info) -> const server_info& { return *info; });
+			servers.insert(position, std::move(entry));
+			servers_dirty = true;
 			trigger_refresh();
 		}
 
+		int get_round_trip_percentile(std::vector<int> samples, const size_t percentile)
+		{
+			if (samples.empty())
+			{
+				return 0;
+			}
+
+			const auto index = (samples.size() - 1) * percentile / 100;
+			std::ranges::nth_element(samples, samples.begin() + index);
+			return samples[index];
+		}
+
+		void print_query_stats()
+		{
+			console::info("Servers: %zu queried / %zu total, %zu responded, %zu timed out, %zu pending\n",
+			              query_stats.queried, query_stats.total, query_stats.responded, query_stats.timed_out,
+			              master_state.queued_servers.size());
+			console::info("Round trip: p50 %dms, p99 %dms\n",
+			              get_round_trip_percentile(query_stats.round_trip_times, 50),
+			              get_round_trip_percentile(query_stats.round_trip_times, 99));
+		}
+
+		void update_send_budget(const std::chrono::steady_clock::time_point now)
+		{
+			const auto rate = static_cast<double>(sl_query_rate ? sl_query_rate->current.integer : 200);
+			const auto elapsed = std::chrono::duration<double>(now - master_state.last_budget_update).count();
+			master_state.last_budget_update = now;
+
+			// Allow bursts of up to 100ms worth of packets
+			master_state.send_budget = std::min(master_state.send_budget + elapsed * rate, std::max(1.0, rate / 10.0));
+		}
+
 		void do_frame_work()
 		{
+			std::lock_guard<std::mutex> _(mutex);
+
+			if (servers_dirty)
+			{
+				publish_snapshot();
+			}
+
 			auto& queue = master_state.queued_servers;
 			if (queue.empty())
 			{
+				if (!query_stats.reported && !master_state.requesting)
+				{
+					query_stats.reported = true;
+					print_query_stats();
+				}
+
 				return;
 			}
 
-			std::lock_guard<std::mutex> _(mutex);
-
-			size_t queried_servers = 0;
-			const size_t query_limit = 3;
+			const auto now = std::chrono::steady_clock::now();
+			update_send_budget(now);
 
 			for (auto i = queue.begin(); i != queue.end();)
 			{
-				if (i->second)
+				auto& query = i->second;
+
+				if (query.attempts)
 				{
-					const auto now = game::Sys_Milliseconds();
-					if (now - i->second > 10'000)
+					// Back off exponentially between attempts
+					const auto timeout = query_timeout * (1 << (query.attempts - 1));
+					if (now - query.sent_at < timeout)
 					{
+						++i;
+						continue;
+					}
+
+					if (query.attempts >= query_attempts)
+					{
+						++query_stats.timed_out;
 						i = queue.erase(i);
 						continue;
 					}
 				}
-				else if (queried_servers++ < query_limit)
+
+				if (master_state.send_budget >= 1.0)
 				{
-					i->second = game::Sys_Milliseconds();
-					network::send(i->first, "getInfo", utils::cryptography::random::get_challenge());
+					master_state.send_budget -= 1.0;
+
+					if (!query.attempts)
+					{
+						++query_stats.queried;
+					}
+
+					++query.attempts;
+					query.challenge = utils::cryptography::random::get_challenge();
+					query.sent_at = now;
+
+					network::send(i->first, "getInfo", query.challenge);
 				}
 
 				++i;
@@ -230,7 +349,7 @@ namespace server_list
 				return false;
 			}
 
-			if (server_list_index + 16 < servers.size())
+			if (server_list_index + 16 < get_snapshot()->size())
 			{
 				++server_list_index;
 				trigger_refresh();
@@ -257,12 +376,11 @@ namespace server_list
 
 		int get_client_count()
 		{
-			std::lock_guard<std::mutex> _(mutex);
 			auto count = 0;
 
-			for (const auto& server : servers)
+			for (const auto& server : *get_snapshot())
 			{
-				count += server.clients;
+				count += server->clients;
 			}
 
 			return count;
@@ -270,12 +388,11 @@ namespace server_list
 
 		int get_bot_count()
 		{
-			std::lock_guard<std::mutex> _(mutex);
 			auto count = 0;
 
-			for (const auto& server : servers)
+			for (const auto& server : *get_snapshot())
 			{
-				count += server.bots;
+				count += server->bots;
 			}
 
 			return count;
@@ -283,17 +400,25 @@ namespace server_list
 
 		int get_max_clients_count()
 		{
-			std::lock_guard<std::mutex> _(mutex);
 			auto count = 0;
 
-			for (const auto& server : servers)
+			for (const auto& server : *get_snapshot())
 			{
-				count += server.max_clients;
+				count += server->max_clients;
 			}
 
 			return count;
 		}
 
+		int get_int_value(const utils::info_string_view& info, const std::string_view key)
+		{
+			const auto value = info.get(key);
+
+			auto result = 0;
+			std::from_chars(value.data(), value.data() + value.size(), result);
+			return result;
+		}
+
 		int get_total_active_players_count_stub(game::hks::lua_State* s, void* a2)
 		{
 			const auto clients = get_client_count();
@@ -312,22 +437,31 @@ namespace server_list
 		return game::NET_StringToAdr("master.xlabs.dev:20810", &address);
 	}
 
-	void handle_info_response(const game::netadr_s& address, const utils::info_string& info)
+	void handle_info_response(const game::netadr_s& address, const utils::info_string_view& info)
 	{
-		int start_time{};
-		const auto now = game::Sys_Milliseconds();
+		int ping{};
+		const auto now = std::chrono::steady_clock::now();
 
 		{
 			std::lock_guard<std::mutex> _(mutex);
 			const auto entry = master_state.queued_servers.find(address);
 
-			if (entry == master_state.queued_servers.end() || !entry->second)
+			if (entry == master_state.queued_servers.end() || !entry->second.attempts)
+			{
+				return;
+			}
+
+			// Late answers to an earlier attempt would skew the ping
+			if (info.get("challenge") != entry->second.challenge)
 			{
 				return;
 			}
 
-			start_time = entry->second;
+			ping = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(now - entry->second.sent_at).count());
 			master_state.queued_servers.erase(entry);
+
+			++query_stats.responded;
+			query_stats.round_trip_times.push_back(ping);
 		}
 
 		if (dvars::get_string("ui_customModeName") == "mp"s)
@@ -358,12 +492,12 @@ namespace server_list
 		server_info server{};
 		server.address = address;
 		server.host_name = info.get("hostname");
-		server.map_name = game::UI_LocalizeMapname(info.get("mapname").data());
-		server.game_type = game::UI_LocalizeGametype(info.get("gametype").data());
-		server.clients = atoi(info.get("clients").data());
-		server.max_clients = atoi(info.get("sv_maxclients").data());
-		server.bots = atoi(info.get("bots").data());
-		server.ping = now - start_time;
+		server.map_name = game::UI_LocalizeMapname(std::string{info.get("mapname")}.data());
+		server.game_type = game::UI_LocalizeGametype(std::string{info.get("gametype")}.data());
+		server.clients = get_int_value(info, "clients");
+		server.max_clients = get_int_value(info, "sv_maxclients");
+		server.bots = get_int_value(info, "bots");
+		server.ping = ping;
 		server.is_private = info.get("isPrivate") == "1"s;
 		server.in_game = 1;
 
@@ -434,6 +568,15 @@ namespace server_list
 				game::LUI_OpenMenu(0, params[1], 1, 0, 0);
 			});
 
+			sl_query_rate = game::Dvar_RegisterInt("sl_queryRate", 200, 10, 1000, game::DVAR_FLAG_SAVED,
+			                                       "Server list queries sent per second");
+
+			command::add("serverlist_stats", []()
+			{
+				std::lock_guard<std::mutex> _(mutex);
+				print_query_stats();
+			});
+
 			scheduler::loop(do_frame_work, scheduler::pipeline::main);
 
 			network::on("getServersResponse", [](const game::netadr_s& target, const std::string& data)
@@ -475,8 +618,14 @@ namespace server_list
 						std::memcpy(&address.ip[0], data.data() + i + 0, 4);
 						std::memcpy(&address.port, data.data() + i + 4, 2);
 
-						master_state.queued_servers[address] = 0;
+						if (master_state.queued_servers.emplace(address, server_query{}).second)
+						{
+							++query_stats.total;
+						}
 					}
+
+					query_stats.reported = false;
+					master_state.last_budget_update = std::chrono::steady_clock::now();
 				}
 			});
 		}
@@ -4,7 +4,7 @@
 namespace server_list
 {
 	bool get_master_server(game::netadr_s& address);
-	void handle_info_response(const game::netadr_s& address, const utils::info_string& info);
+	void handle_info_response(const game::netadr_s& address, const utils::info_string_view& info);
 
 	bool sl_key_event(int key, int down);
 }
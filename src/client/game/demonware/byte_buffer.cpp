@@ -74,19 +74,21 @@ namespace demonware
 	{
 		if (!this->read_data_type(16)) return false;
 
+		const auto length = this->buffer_.find('\0', this->current_byte_);
+		if (length == std::string::npos) return false;
+
 		*output = const_cast<char*>(this->buffer_.data()) + this->current_byte_;
-		this->current_byte_ += strlen(*output) + 1;
+		this->current_byte_ = length + 1;
 
 		return true;
 	}
 
 	bool byte_buffer::read_string(char* output, const int length)
 	{
-		if (!this->read_data_type(16)) return false;
-
-		strcpy_s(output, length, const_cast<char*>(this->buffer_.data()) + this->current_byte_);
-		this->current_byte_ += strlen(output) + 1;
+		char* data;
+		if (!this->read_string(&data)) return false;
 
+		strcpy_s(output, length, data);
 		return true;
 	}
 
@@ -112,7 +114,8 @@ namespace demonware
 		}
 
 		unsigned int size;
-		this->read_uint32(&size);
+		if (!this->read_uint32(&size)) return false;
+		if (size > this->buffer_.size() - this->current_byte_) return false;
 
 		*output = const_cast<char*>(this->buffer_.data()) + this->current_byte_;
 		*length = static_cast<int>(size);
@@ -127,7 +130,7 @@ namespace demonware
 		if (!this->use_data_types_) return true;
 
 		char type;
-		this->read(1, &type);
+		if (!this->read(1, &type)) return false;
 		if (type != expected)
 		{
 			//throw std::runtime_error("Data type mismatch!");
@@ -148,11 +151,13 @@ namespace demonware
 		if (!this->read_uint32(&array_size)) return false;
 
 		this->set_use_data_types(false);
-		this->read_uint32(&el_count);
+		const auto result = this->read_uint32(&el_count);
 		this->set_use_data_types(true);
 
+		if (!result) return false;
+
 		if (element_count) *element_count = el_count;
-		if (element_size) *element_size = array_size / el_count;
+		if (element_size) *element_size = el_count ? array_size / el_count : 0;
 
 		return true;
 	}
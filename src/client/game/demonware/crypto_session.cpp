@@ -0,0 +1,93 @@
+#include <std_include.hpp>
+#include "component/demonware.hpp"
+#include "crypto_session.hpp"
+
+namespace demonware
+{
+	crypto_session::crypto_session() : cipher_(find_cipher("3des"))
+	{
+		this->encryption_.encrypt = true;
+		this->decryption_.encrypt = false;
+	}
+
+	bool crypto_session::encrypt(const uint32_t seed, char* data, const size_t length)
+	{
+		return this->process(this->encryption_, seed, data, length);
+	}
+
+	bool crypto_session::decrypt(const uint32_t seed, char* data, const size_t length)
+	{
+		return this->process(this->decryption_, seed, data, length);
+	}
+
+	bool crypto_session::process(direction& state, const uint32_t seed, char* data, const size_t length) const
+	{
+		const auto aligned_length = static_cast<unsigned long>(length & ~(block_size - 1));
+		if (!aligned_length)
+		{
+			return true;
+		}
+
+		std::lock_guard<std::mutex> _(state.mutex);
+
+		if (!this->update_key(state))
+		{
+			return false;
+		}
+
+		update_iv(state, seed);
+
+		// Copying the started state reuses its key schedule, only the IV differs per message
+		auto cbc = state.cbc;
+		if (cbc_setiv(state.iv, block_size, &cbc) != CRYPT_OK)
+		{
+			return false;
+		}
+
+		auto* buffer = reinterpret_cast<uint8_t*>(data);
+		const auto result = state.encrypt
+			? cbc_encrypt(buffer, buffer, aligned_length, &cbc)
+			: cbc_decrypt(buffer, buffer, aligned_length, &cbc);
+
+		return result == CRYPT_OK;
+	}
+
+	bool crypto_session::update_key(direction& state) const
+	{
+		uint8_t key[key_size];
+		get_key(state.encrypt, key);
+
+		if (state.keyed && !std::memcmp(state.key, key, key_size))
+		{
+			return true;
+		}
+
+		if (state.keyed)
+		{
+			cbc_done(&state.cbc);
+		}
+
+		std::memcpy(state.key, key, key_size);
+		state.keyed = cbc_start(this->cipher_, state.iv, state.key, key_size, 0, &state.cbc) == CRYPT_OK;
+		return state.keyed;
+	}
+
+	void crypto_session::update_iv(direction& state, const uint32_t seed)
+	{
+		if (state.seeded && state.seed == seed)
+		{
+			return;
+		}
+
+		uint8_t hash[24];
+
+		hash_state tiger_state;
+		tiger_init(&tiger_state);
+		tiger_process(&tiger_state, reinterpret_cast<const uint8_t*>(&seed), sizeof(seed));
+		tiger_done(&tiger_state, hash);
+
+		std::memcpy(state.iv, hash, block_size);
+		state.seed = seed;
+		state.seeded = true;
+	}
+}
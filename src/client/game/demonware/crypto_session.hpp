@@ -0,0 +1,42 @@
+#pragma once
+
+namespace demonware
+{
+	// 3DES-CBC state for one server. The key schedule is only rebuilt when
+	// the session key changes and the Tiger derived IV is remembered per seed.
+	class crypto_session final
+	{
+	public:
+		crypto_session();
+
+		// Data is processed in place, trailing bytes past the last full block are left untouched
+		bool encrypt(uint32_t seed, char* data, size_t length);
+		bool decrypt(uint32_t seed, char* data, size_t length);
+
+	private:
+		static constexpr size_t key_size = 24;
+		static constexpr size_t block_size = 8;
+
+		struct direction
+		{
+			std::mutex mutex;
+			bool encrypt;
+
+			bool keyed = false;
+			uint8_t key[key_size]{};
+			symmetric_CBC cbc{};
+
+			bool seeded = false;
+			uint32_t seed = 0;
+			uint8_t iv[block_size]{};
+		};
+
+		int cipher_;
+		direction encryption_;
+		direction decryption_;
+
+		bool process(direction& state, uint32_t seed, char* data, size_t length) const;
+		bool update_key(direction& state) const;
+		static void update_iv(direction& state, uint32_t seed);
+	};
+}
@@ -8,17 +8,22 @@ namespace demonware
 	{
 	public:
 		std::string file_data;
+		std::shared_ptr<const std::string> shared_data;
 
 		explicit bdFileData(std::string buffer) : file_data(std::move(buffer))
 		{
 		}
 
+		explicit bdFileData(std::shared_ptr<const std::string> buffer) : shared_data(std::move(buffer))
+		{
+		}
+
 		void serialize(byte_buffer* buffer) override
 		{
-			buffer->write_blob(this->file_data);
+			buffer->write_blob(this->shared_data ? *this->shared_data : this->file_data);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			buffer->read_blob(&this->file_data);
 		}
@@ -46,7 +51,7 @@ namespace demonware
 			buffer->write_string(this->filename);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			buffer->read_uint32(&this->file_size);
 			buffer->read_uint64(&this->file_id);
@@ -76,7 +81,7 @@ namespace demonware
 			buffer->write_uint32(this->group_count);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			buffer->read_uint32(&this->group_id);
 			buffer->read_uint32(&this->group_count);
@@ -93,7 +98,7 @@ namespace demonware
 			buffer->write_uint32(this->unix_time);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			buffer->read_uint32(&this->unix_time);
 		}
@@ -119,7 +124,7 @@ namespace demonware
 			buffer->write_float(this->longitude);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			buffer->read_string(&this->country_code);
 			buffer->read_string(&this->country);
@@ -144,7 +149,7 @@ namespace demonware
 			buffer->write_string(this->timezone);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			bdDMLInfo::deserialize(buffer);
 
@@ -163,15 +168,14 @@ namespace demonware
 			buffer->write_blob(LPSTR(&this->session_id), sizeof this->session_id);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
-			int size{};
-			char* data{};
-			buffer->read_blob(&data, &size);
+			std::string_view data{};
+			buffer->read_blob(&data);
 
-			if (data && uint32_t(size) >= sizeof(this->session_id))
+			if (data.size() >= sizeof(this->session_id))
 			{
-				this->session_id = *reinterpret_cast<uint64_t*>(data);
+				std::memcpy(&this->session_id, data.data(), sizeof(this->session_id));
 			}
 		}
 	};
@@ -196,7 +200,7 @@ namespace demonware
 			buffer->write_uint32(this->num_players);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			buffer->read_blob(&this->host_addr);
 
@@ -251,7 +255,7 @@ namespace demonware
 			buffer->write_uint32(this->coop_state);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			bdMatchmakingInfo::deserialize(buffer);
 
@@ -286,7 +290,7 @@ namespace demonware
 			buffer->write_int64(this->performance);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			buffer->read_uint64(&this->user_id);
 			buffer->read_int64(&this->performance);
@@ -352,7 +356,7 @@ namespace demonware
 			buffer->set_use_data_types(data_types);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			const auto data_types = buffer->is_using_data_types();
 			buffer->set_use_data_types(false);
@@ -382,7 +386,7 @@ namespace demonware
 			buffer->set_use_data_types(data_types);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			const auto data_types = buffer->is_using_data_types();
 			buffer->set_use_data_types(false);
@@ -423,7 +427,7 @@ namespace demonware
 			buffer->set_use_data_types(data_types);
 		}
 
-		void deserialize(byte_buffer* buffer) override
+		void deserialize(byte_buffer_view* buffer) override
 		{
 			const auto data_types = buffer->is_using_data_types();
 			buffer->set_use_data_types(false);
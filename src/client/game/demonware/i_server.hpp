@@ -1,6 +1,8 @@
 #pragma once
 #include "bit_buffer.hpp"
 #include "byte_buffer.hpp"
+#include "byte_buffer_view.hpp"
+#include "crypto_session.hpp"
 
 namespace demonware
 {
@@ -46,17 +48,22 @@ namespace demonware
 	class encrypted_reply final : public typed_reply
 	{
 	public:
-		encrypted_reply(const uint8_t type, bit_buffer* bbuffer) : typed_reply(type)
+		encrypted_reply(const uint8_t type, bit_buffer* bbuffer, crypto_session* session)
+			: typed_reply(type), session_(session)
 		{
 			this->buffer_.append(bbuffer->get_buffer());
 		}
 
-		encrypted_reply(const uint8_t type, byte_buffer* bbuffer) : typed_reply(type)
+		encrypted_reply(const uint8_t type, byte_buffer* bbuffer, crypto_session* session)
+			: typed_reply(type), session_(session)
 		{
 			this->buffer_.append(bbuffer->get_buffer());
 		}
 
 		virtual std::string get_data() override;
+
+	private:
+		crypto_session* session_;
 	};
 
 	class unencrypted_reply final : public typed_reply
@@ -86,6 +93,7 @@ namespace demonware
 		virtual int recv(char* buf, int len) = 0;
 
 		virtual void send_reply(reply* reply) = 0;
+		virtual crypto_session* get_crypto_session() = 0;
 
 		virtual std::shared_ptr<remote_reply> create_message(uint8_t type)
 		{
@@ -113,7 +121,7 @@ namespace demonware
 		{
 			std::unique_ptr<typed_reply> reply;
 
-			if (encrypted) reply = std::make_unique<encrypted_reply>(this->type_, buffer);
+			if (encrypted) reply = std::make_unique<encrypted_reply>(this->type_, buffer, this->server_->get_crypto_session());
 			else reply = std::make_unique<unencrypted_reply>(this->type_, buffer);
 			this->server_->send_reply(reply.get());
 		}
@@ -134,7 +142,7 @@ namespace demonware
 		{
 		}
 
-		virtual void deserialize(byte_buffer* /*buffer*/)
+		virtual void deserialize(byte_buffer_view* /*buffer*/)
 		{
 		}
 	};
@@ -149,7 +157,7 @@ namespace demonware
 
 		uint64_t send()
 		{
-			static uint64_t id = 0x8000000000000001;
+			static std::atomic<uint64_t> id = 0x8000000000000001;
 			const auto transaction_id = ++id;
 
 			byte_buffer buffer;
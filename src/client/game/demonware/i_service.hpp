@@ -17,15 +17,18 @@ namespace demonware
 		i_service(const i_service&) = delete;
 		i_service& operator=(const i_service&) = delete;
 
-		typedef std::function<void(i_server*, byte_buffer*)> callback;
+		typedef std::function<void(i_server*, byte_buffer_view*)> callback;
 
 		virtual uint16_t getType() = 0;
 
-		virtual void call_service(i_server* server, const std::string& data)
+		// Services that change connection state used by parse_packet must not run on the worker pool
+		virtual bool requires_server_thread() const { return false; }
+
+		virtual void call_service(i_server* server, const std::string_view data)
 		{
 			std::lock_guard _(this->mutex_);
 
-			byte_buffer buffer(data);
+			byte_buffer_view buffer(data);
 			buffer.read_byte(&this->sub_type_);
 #ifdef DEBUG
 			printf("DW: Handling subservice of type %d\n", this->sub_type_);
@@ -0,0 +1,111 @@
+#include <std_include.hpp>
+#include "service_dispatcher.hpp"
+
+#include <utils/string.hpp>
+#include <utils/thread.hpp>
+
+namespace demonware
+{
+	service_dispatcher::service_dispatcher(const size_t worker_count)
+	{
+		this->workers_.reserve(worker_count);
+
+		for (size_t i = 0; i < worker_count; ++i)
+		{
+			this->workers_.push_back(utils::thread::create_named_thread(utils::string::va("Demonware Worker %zu", i), [this]()
+			{
+				this->worker();
+			}));
+		}
+	}
+
+	service_dispatcher::~service_dispatcher()
+	{
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			this->terminate_ = true;
+		}
+
+		this->condition_.notify_all();
+
+		for (auto& worker : this->workers_)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+	}
+
+	void service_dispatcher::post(strand& strand, job task)
+	{
+		{
+			std::lock_guard<std::mutex> _(strand.mutex_);
+			strand.jobs_.push(std::move(task));
+
+			if (strand.scheduled_)
+			{
+				return;
+			}
+
+			strand.scheduled_ = true;
+		}
+
+		this->schedule(strand);
+	}
+
+	void service_dispatcher::schedule(strand& strand)
+	{
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			this->ready_strands_.push(&strand);
+		}
+
+		this->condition_.notify_one();
+	}
+
+	void service_dispatcher::worker()
+	{
+		while (true)
+		{
+			strand* current{};
+
+			{
+				std::unique_lock<std::mutex> lock(this->mutex_);
+				this->condition_.wait(lock, [this]()
+				{
+					return this->terminate_ || !this->ready_strands_.empty();
+				});
+
+				// Drain before exiting, queued calls may be storage uploads made right before quitting.
+				// A strand that is being run is requeued by its worker, so that worker finishes it.
+				if (this->ready_strands_.empty()) return;
+
+				current = this->ready_strands_.front();
+				this->ready_strands_.pop();
+			}
+
+			job task{};
+
+			{
+				std::lock_guard<std::mutex> _(current->mutex_);
+				task = std::move(current->jobs_.front());
+				current->jobs_.pop();
+			}
+
+			task();
+
+			// Run one job per turn and requeue, so a busy service can't starve the others
+			{
+				std::lock_guard<std::mutex> _(current->mutex_);
+				if (current->jobs_.empty())
+				{
+					current->scheduled_ = false;
+					continue;
+				}
+			}
+
+			this->schedule(*current);
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+namespace demonware
+{
+	// Small worker pool for demonware service calls.
+	// Jobs posted to the same strand run one at a time in posting order,
+	// different strands run concurrently. Destruction runs every queued job first.
+	class service_dispatcher final
+	{
+	public:
+		using job = std::function<void()>;
+
+		class strand final
+		{
+		private:
+			friend class service_dispatcher;
+
+			std::mutex mutex_;
+			std::queue<job> jobs_;
+			bool scheduled_ = false;
+		};
+
+		explicit service_dispatcher(size_t worker_count);
+		~service_dispatcher();
+
+		service_dispatcher(service_dispatcher&&) = delete;
+		service_dispatcher(const service_dispatcher&) = delete;
+		service_dispatcher& operator=(service_dispatcher&&) = delete;
+		service_dispatcher& operator=(const service_dispatcher&) = delete;
+
+		void post(strand& strand, job task);
+
+	private:
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::queue<strand*> ready_strands_;
+		bool terminate_ = false;
+
+		std::vector<std::thread> workers_;
+
+		void schedule(strand& strand);
+		void worker();
+	};
+}
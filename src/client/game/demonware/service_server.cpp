@@ -21,35 +21,38 @@ namespace demonware
 
 	std::string encrypted_reply::get_data()
 	{
-		byte_buffer result;
-		result.set_use_data_types(false);
-
-		byte_buffer enc_buffer;
-		enc_buffer.set_use_data_types(false);
-		enc_buffer.write_int32(0xDEADBEEF);
-		enc_buffer.write_byte(this->get_type());
-		enc_buffer.write(this->buffer_);
+		constexpr uint32_t seed = 0x13371337;
+		constexpr uint32_t checksum = 0xDEADBEEF;
+		constexpr size_t header_size = sizeof(int32_t) + sizeof(bool) + sizeof(seed);
 
-		auto data = enc_buffer.get_buffer();
+		const auto type = this->get_type();
 
-		auto size = enc_buffer.size();
+		auto size = sizeof(checksum) + sizeof(type) + this->buffer_.size();
 		size = ~7 & (size + 7); // 8 byte align
-		data.resize(size);
 
-		result.write_int32(static_cast<int>(size) + 5);
-		result.write_byte(true);
+		// Assemble the whole packet once and encrypt the payload where it already sits
+		std::string result(header_size + size, '\0');
+		auto* data = result.data();
 
-		auto seed = 0x13371337;
-		result.write_int32(seed);
+		const auto length = static_cast<int32_t>(size) + 5;
+		const auto encrypted = true;
 
-		const auto iv = utils::cryptography::tiger::compute(std::string(reinterpret_cast<char*>(&seed), 4));
+		std::memcpy(data, &length, sizeof(length));
+		std::memcpy(data + 4, &encrypted, sizeof(encrypted));
+		std::memcpy(data + 5, &seed, sizeof(seed));
 
-		const std::string key(reinterpret_cast<char*>(get_key(true)), 24);
-		result.write(utils::cryptography::des3::encrypt(data, iv, key));
+		auto* payload = data + header_size;
+		std::memcpy(payload, &checksum, sizeof(checksum));
+		std::memcpy(payload + sizeof(checksum), &type, sizeof(type));
+		std::memcpy(payload + sizeof(checksum) + sizeof(type), this->buffer_.data(), this->buffer_.size());
 
-		return result.get_buffer();
+		this->session_->encrypt(seed, payload, size);
+
+		return result;
 	}
 
+	thread_local service_server::call_context* service_server::current_call_ = nullptr;
+
 	service_server::service_server(std::string _name) : name_(std::move(_name))
 	{
 		this->address_ = utils::cryptography::jenkins_one_at_a_time::compute(this->name_);
@@ -60,78 +63,228 @@ namespace demonware
 		return this->address_;
 	}
 
+	const std::string& service_server::get_name() const
+	{
+		return this->name_;
+	}
+
 	int service_server::send(const char* buf, const int len)
 	{
 		if (len <= 3) return -1;
 		std::lock_guard<std::recursive_mutex> _(this->mutex_);
 
 		this->incoming_queue_.push(std::string(buf, len));
+		wake_server_thread();
 
 		return len;
 	}
 
-	int service_server::recv(char* buf, int len)
+	int service_server::recv(char* buf, const int len)
 	{
-		if (len > 0 && !this->outgoing_queue_.empty())
+		if (len <= 0) return SOCKET_ERROR;
+
+		std::lock_guard<std::recursive_mutex> _(this->mutex_);
+		if (this->outgoing_queue_.empty()) return SOCKET_ERROR;
+
+		auto written = 0;
+		while (written < len && !this->outgoing_queue_.empty())
 		{
-			std::lock_guard<std::recursive_mutex> _(this->mutex_);
+			const auto& segment = this->outgoing_queue_.front();
+			const auto available = segment.size() - this->outgoing_offset_;
+			const auto count = std::min(available, static_cast<size_t>(len - written));
+
+			std::memcpy(buf + written, segment.data() + this->outgoing_offset_, count);
+			written += static_cast<int>(count);
+			this->outgoing_offset_ += count;
 
-			len = std::min(len, static_cast<int>(this->outgoing_queue_.size()));
-			for (auto i = 0; i < len; ++i)
+			if (this->outgoing_offset_ >= segment.size())
 			{
-				buf[i] = this->outgoing_queue_.front();
 				this->outgoing_queue_.pop();
+				this->outgoing_offset_ = 0;
 			}
-
-			return len;
 		}
 
-		return SOCKET_ERROR;
+		return written;
+	}
+
+	crypto_session* service_server::get_crypto_session()
+	{
+		return &this->crypto_session_;
 	}
 
 	void service_server::send_reply(reply* data)
 	{
 		if (!data) return;
 
+		auto buffer = data->get_data();
+
+		if (current_call_ && current_call_->server == this)
+		{
+			current_call_->reply_sent = true;
+			if (!buffer.empty())
+			{
+				current_call_->replies.push_back(std::move(buffer));
+			}
+
+			return;
+		}
+
+		std::vector<std::string> replies{};
+		if (!buffer.empty())
+		{
+			replies.push_back(std::move(buffer));
+		}
+
+		this->finish_call(this->begin_call(), std::move(replies));
+	}
+
+	uint64_t service_server::begin_call()
+	{
 		std::lock_guard<std::recursive_mutex> _(this->mutex_);
+		return this->next_sequence_++;
+	}
 
-		this->reply_sent_ = true;
-		const auto buffer = data->get_data();
-		for (const auto& byte : buffer)
+	void service_server::finish_call(const uint64_t sequence, std::vector<std::string> replies)
+	{
+		std::lock_guard<std::recursive_mutex> _(this->mutex_);
+		this->finished_calls_[sequence] = std::move(replies);
+
+		auto released = false;
+		while (!this->finished_calls_.empty() && this->finished_calls_.begin()->first == this->next_reply_sequence_)
+		{
+			for (auto& reply : this->finished_calls_.begin()->second)
+			{
+				this->outgoing_queue_.push(std::move(reply));
+				released = true;
+			}
+
+			this->finished_calls_.erase(this->finished_calls_.begin());
+			++this->next_reply_sequence_;
+		}
+
+		if (released)
 		{
-			this->outgoing_queue_.push(byte);
+			this->outgoing_condition_.notify_all();
 		}
 	}
 
-	void service_server::call_handler(const uint8_t type, const std::string& data)
+	bool service_server::wait_for_data(const std::chrono::milliseconds timeout)
+	{
+		std::unique_lock<std::recursive_mutex> lock(this->mutex_);
+		return this->outgoing_condition_.wait_for(lock, timeout, [this]()
+		{
+			return !this->outgoing_queue_.empty();
+		});
+	}
+
+	void service_server::dispatch(const uint8_t type, const std::shared_ptr<std::string>& packet, const std::string_view data)
 	{
-		if (this->services_.find(type) != this->services_.end())
+		const auto sequence = this->begin_call();
+
+		const auto entry = this->services_.find(type);
+		auto* slot = entry == this->services_.end() ? nullptr : entry->second.get();
+
+		auto* dispatcher = get_service_dispatcher();
+		if (!slot || !dispatcher || slot->service->requires_server_thread())
 		{
-			this->services_[type]->call_service(this, data);
+			this->call_handler(slot, type, data, sequence);
+			return;
 		}
-		else
+
+		// The packet stays alive until the call ran, data points into it
+		dispatcher->post(slot->strand, [this, slot, type, packet, data, sequence, posted = std::chrono::steady_clock::now()]()
+		{
+			const auto wait = std::chrono::steady_clock::now() - posted;
+			slot->total_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(wait).count();
+
+			this->call_handler(slot, type, data, sequence);
+		});
+	}
+
+	void service_server::call_handler(service_slot* slot, const uint8_t type, const std::string_view data, const uint64_t sequence)
+	{
+		call_context call{this, sequence, {}, false};
+		current_call_ = &call;
+
+		try
 		{
+			if (slot)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				slot->service->call_service(this, data);
+
+				const auto duration = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - start).count());
+
+				++slot->calls;
+				slot->total_us += duration;
+
+				auto max = slot->max_us.load();
+				while (duration > max && !slot->max_us.compare_exchange_weak(max, duration))
+				{
+				}
+			}
+			else
+			{
 #ifdef DEBUG
-			printf("DW: Missing handler of type %d\n", type);
+				printf("DW: Missing handler of type %d\n", type);
 #endif
+			}
+
+			if (!call.reply_sent && type != 7)
+			{
+				this->create_reply(type)->send();
+			}
+		}
+		catch (...)
+		{
 		}
+
+		// Always finish the call, a missing sequence number would hold back every later reply
+		current_call_ = nullptr;
+		this->finish_call(sequence, std::move(call.replies));
+	}
+
+	std::vector<service_server::service_statistics> service_server::get_service_statistics() const
+	{
+		std::vector<service_statistics> statistics{};
+		statistics.reserve(this->services_.size());
+
+		for (const auto& [type, slot] : this->services_)
+		{
+			statistics.push_back({
+				type,
+				slot->calls.load(),
+				slot->total_us.load(),
+				slot->max_us.load(),
+				slot->total_wait_us.load(),
+			});
+		}
+
+		return statistics;
 	}
 
 	void service_server::run_frame()
 	{
-		if (!this->incoming_queue_.empty())
+		while (true)
 		{
-			std::lock_guard<std::recursive_mutex> _(this->mutex_);
-			const auto packet = this->incoming_queue_.front();
-			this->incoming_queue_.pop();
+			std::shared_ptr<std::string> packet;
+
+			{
+				std::lock_guard<std::recursive_mutex> _(this->mutex_);
+				if (this->incoming_queue_.empty()) return;
+
+				packet = std::make_shared<std::string>(std::move(this->incoming_queue_.front()));
+				this->incoming_queue_.pop();
+			}
 
 			this->parse_packet(packet);
 		}
 	}
 
-	void service_server::parse_packet(const std::string& packet)
+	void service_server::parse_packet(const std::shared_ptr<std::string>& packet)
 	{
-		byte_buffer buffer(packet);
+		byte_buffer_view buffer(*packet);
 		buffer.set_use_data_types(false);
 
 		try
@@ -139,7 +292,7 @@ namespace demonware
 			while (buffer.has_more_data())
 			{
 				int size;
-				buffer.read_int32(&size);
+				if (!buffer.read_int32(&size)) return;
 
 				if (size <= 0)
 				{
@@ -159,44 +312,37 @@ namespace demonware
 					return;
 				}
 
-				if (buffer.size() < size_t(size)) return;
+				const auto packet_offset = buffer.offset();
 
-				byte_buffer p_buffer;
+				std::string_view packet_data;
+				if (!buffer.read(size_t(size), &packet_data)) return;
+
+				byte_buffer_view p_buffer(packet_data);
 				p_buffer.set_use_data_types(false);
-				p_buffer.get_buffer().resize(size);
-				buffer.read(size, p_buffer.get_buffer().data());
 
 				bool enc;
-				p_buffer.read_bool(&enc);
+				if (!p_buffer.read_bool(&enc)) return;
 
 				if (enc)
 				{
 					int iv;
-					p_buffer.read_int32(&iv);
-
-					auto iv_hash = utils::cryptography::tiger::compute(std::string(reinterpret_cast<char*>(&iv), 4));
+					if (!p_buffer.read_int32(&iv)) return;
 
-					const std::string key(reinterpret_cast<char*>(get_key(false)), 24);
-					p_buffer = byte_buffer{utils::cryptography::des3::decrypt(p_buffer.get_remaining(), iv_hash, key)};
-					p_buffer.set_use_data_types(false);
+					// The view aliases the packet, so decrypting the owning string in place is visible through it
+					this->crypto_session_.decrypt(static_cast<uint32_t>(iv), packet->data() + packet_offset + p_buffer.offset(),
+					                              p_buffer.get_remaining().size());
 
 					int checksum;
 					p_buffer.read_int32(&checksum);
 				}
 
 				uint8_t type;
-				p_buffer.read_byte(&type);
+				if (!p_buffer.read_byte(&type)) return;
 #ifdef DEBUG
 				printf("DW: Handling message of type %d (encrypted: %d)\n", type, enc);
 #endif
 
-				this->reply_sent_ = false;
-				this->call_handler(type, p_buffer.get_remaining());
-
-				if (!this->reply_sent_ && type != 7)
-				{
-					this->create_reply(type)->send();
-				}
+				this->dispatch(type, packet, p_buffer.get_remaining());
 			}
 		}
 		catch (...)
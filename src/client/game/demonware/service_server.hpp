@@ -1,11 +1,21 @@
 #pragma once
 #include "i_service.hpp"
+#include "service_dispatcher.hpp"
 
 namespace demonware
 {
 	class service_server final : public i_server
 	{
 	public:
+		struct service_statistics
+		{
+			uint16_t type;
+			uint64_t calls;
+			uint64_t total_us;
+			uint64_t max_us;
+			uint64_t total_wait_us;
+		};
+
 		explicit service_server(std::string name);
 
 		template <typename T>
@@ -13,31 +23,71 @@ namespace demonware
 		{
 			static_assert(std::is_base_of<i_service, T>::value, "Service must inherit from IService");
 
-			auto service = std::make_unique<T>();
-			const uint16_t type = service->getType();
+			auto slot = std::make_unique<service_slot>();
+			slot->service = std::make_unique<T>();
+			const uint16_t type = slot->service->getType();
 
-			this->services_[type] = std::move(service);
+			this->services_[type] = std::move(slot);
 		}
 
 		unsigned long get_address() const;
+		const std::string& get_name() const;
 
 		int send(const char* buf, int len) override;
 		int recv(char* buf, int len) override;
 		void send_reply(reply* data) override;
+		crypto_session* get_crypto_session() override;
+
+		bool wait_for_data(std::chrono::milliseconds timeout);
 
-		void call_handler(uint8_t type, const std::string& data);
 		void run_frame();
 
+		std::vector<service_statistics> get_service_statistics() const;
+
 	private:
+		struct service_slot
+		{
+			std::unique_ptr<i_service> service;
+			service_dispatcher::strand strand;
+
+			std::atomic<uint64_t> calls{0};
+			std::atomic<uint64_t> total_us{0};
+			std::atomic<uint64_t> max_us{0};
+			std::atomic<uint64_t> total_wait_us{0};
+		};
+
+		// Replies produced while handling one incoming message
+		struct call_context
+		{
+			service_server* server;
+			uint64_t sequence;
+			std::vector<std::string> replies;
+			bool reply_sent;
+		};
+
+		static thread_local call_context* current_call_;
+
 		std::string name_;
 
 		std::recursive_mutex mutex_;
-		std::queue<char> outgoing_queue_;
+		std::condition_variable_any outgoing_condition_;
+		std::queue<std::string> outgoing_queue_;
+		size_t outgoing_offset_ = 0;
 		std::queue<std::string> incoming_queue_;
-		std::map<uint16_t, std::unique_ptr<i_service>> services_;
+		std::map<uint16_t, std::unique_ptr<service_slot>> services_;
+		crypto_session crypto_session_;
 		unsigned long address_ = 0;
-		bool reply_sent_ = false;
 
-		void parse_packet(const std::string& packet);
+		// Calls may finish out of order, replies are released in the order the requests arrived
+		uint64_t next_sequence_ = 0;
+		uint64_t next_reply_sequence_ = 0;
+		std::map<uint64_t, std::vector<std::string>> finished_calls_;
+
+		void parse_packet(const std::shared_ptr<std::string>& packet);
+		void dispatch(uint8_t type, const std::shared_ptr<std::string>& packet, std::string_view data);
+		void call_handler(service_slot* slot, uint8_t type, std::string_view data, uint64_t sequence);
+
+		uint64_t begin_call();
+		void finish_call(uint64_t sequence, std::vector<std::string> replies);
 	};
 }
@@ -9,7 +9,7 @@ namespace demonware
 		this->register_service(4, &bdAnticheat::report_console_details);
 	}
 
-	void bdAnticheat::report_console_details(i_server* server, [[maybe_unused]] byte_buffer* buffer) const
+	void bdAnticheat::report_console_details(i_server* server, [[maybe_unused]] byte_buffer_view* buffer) const
 	{
 		// TODO: Read data as soon as needed
 		auto reply = server->create_reply(this->get_sub_type());
@@ -9,6 +9,6 @@ namespace demonware
 		bdAnticheat();
 
 	private:
-		void report_console_details(i_server* server, byte_buffer* buffer) const;
+		void report_console_details(i_server* server, byte_buffer_view* buffer) const;
 	};
 }
@@ -13,7 +13,7 @@ namespace demonware
 		0x27, 0x94, 0xD4, 0x8F
 	};
 
-	void bdBandwidthTest::call_service(i_server* server, const std::string& /*data*/)
+	void bdBandwidthTest::call_service(i_server* server, const std::string_view /*data*/)
 	{
 		byte_buffer buffer;
 		buffer.write(sizeof bandwidth_iw6, bandwidth_iw6);
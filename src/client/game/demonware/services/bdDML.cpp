@@ -9,7 +9,7 @@ namespace demonware
 		this->register_service(2, &bdDML::get_user_raw_data);
 	}
 
-	void bdDML::get_user_raw_data(i_server* server, byte_buffer* /*buffer*/) const
+	void bdDML::get_user_raw_data(i_server* server, byte_buffer_view* /*buffer*/) const
 	{
 		auto result = new bdDMLRawData;
 		result->country_code = "US";
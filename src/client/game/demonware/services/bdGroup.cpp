@@ -10,7 +10,7 @@ namespace demonware
 		this->register_service(4, &bdGroup::get_groups);
 	}
 
-	void bdGroup::set_groups(i_server* server, byte_buffer* /*buffer*/) const
+	void bdGroup::set_groups(i_server* server, byte_buffer_view* /*buffer*/) const
 	{
 		//uint32_t groupCount;
 		// TODO: Implement array reading
@@ -19,7 +19,7 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdGroup::get_groups(i_server* server, byte_buffer* buffer)
+	void bdGroup::get_groups(i_server* server, byte_buffer_view* buffer)
 	{
 		uint32_t group_count;
 		buffer->read_array_header(8, &group_count);
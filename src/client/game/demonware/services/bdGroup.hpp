@@ -9,8 +9,8 @@ namespace demonware
 		bdGroup();
 
 	private:
-		void set_groups(i_server* server, byte_buffer* buffer) const;
-		void get_groups(i_server* server, byte_buffer* buffer);
+		void set_groups(i_server* server, byte_buffer_view* buffer) const;
+		void get_groups(i_server* server, byte_buffer_view* buffer);
 
 		uint32_t groups[512]{};
 	};
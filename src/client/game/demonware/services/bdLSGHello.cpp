@@ -4,9 +4,9 @@
 
 namespace demonware
 {
-	void bdLSGHello::call_service(i_server* server, const std::string& data)
+	void bdLSGHello::call_service(i_server* server, const std::string_view data)
 	{
-		bit_buffer buffer(data);
+		bit_buffer buffer{std::string{data}};
 
 		bool more_data;
 		buffer.set_use_data_types(false);
@@ -6,6 +6,9 @@ namespace demonware
 	class bdLSGHello final : public i_generic_service<7>
 	{
 	public:
-		void call_service(i_server* server, const std::string& data) override;
+		void call_service(i_server* server, std::string_view data) override;
+
+		// Installs the session keys, the next packet can only be decrypted once this ran
+		bool requires_server_thread() const override { return true; }
 	};
 }
@@ -1,36 +1,39 @@
 #include <std_include.hpp>
 #include "bdMatchMaking.hpp"
 #include "../data_types.hpp"
+#include "../session_registry.hpp"
 #include "steam/steam.hpp"
 
 namespace demonware
 {
-	std::map<uint64_t, std::shared_ptr<MatchMakingInfo>> sessions;
+	session_registry sessions;
+
+	namespace
+	{
+		// The registry is walked a page at a time, so its lock is never held for the whole result
+		constexpr size_t sessions_per_page = 50;
+	}
 
 	void UpdateSession(const std::string& data)
 	{
-		byte_buffer buffer(data);
+		byte_buffer_view buffer(data);
 
 		auto mmInfo = std::make_shared<MatchMakingInfo>();
 		mmInfo->symmetric = true;
 		mmInfo->deserialize(&buffer);
 		mmInfo->symmetric = false;
 
-		sessions[mmInfo->session_id.session_id] = mmInfo;
+		sessions.update(std::move(mmInfo));
 	}
 
 	void DeleteSession(const std::string& data)
 	{
-		byte_buffer buffer(data);
+		byte_buffer_view buffer(data);
 
 		bdSessionID id;
 		id.deserialize(&buffer);
 
-		const auto session = sessions.find(id.session_id);
-		if (session != sessions.end())
-		{
-			sessions.erase(session);
-		}
+		sessions.remove(id.session_id);
 	}
 
 	bdMatchMaking::bdMatchMaking()
@@ -42,7 +45,7 @@ namespace demonware
 		this->register_service(16, &bdMatchMaking::find_sessions_two_pass);
 	}
 
-	void bdMatchMaking::create_session(i_server* server, byte_buffer* /*buffer*/) const
+	void bdMatchMaking::create_session(i_server* server, byte_buffer_view* /*buffer*/) const
 	{
 		auto* id = new bdSessionID;
 		id->session_id = steam::SteamUser()->GetSteamID().bits;
@@ -52,37 +55,30 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdMatchMaking::update_session(i_server* server, byte_buffer* buffer) const
+	void bdMatchMaking::update_session(i_server* server, byte_buffer_view* buffer) const
 	{
-		MatchMakingInfo mmInfo;
-		mmInfo.session_id.deserialize(buffer);
-		mmInfo.deserialize(buffer);
-
-		byte_buffer out_data;
-		mmInfo.symmetric = true;
-		mmInfo.serialize(&out_data);
+		auto mmInfo = std::make_shared<MatchMakingInfo>();
+		mmInfo->session_id.deserialize(buffer);
+		mmInfo->deserialize(buffer);
 
-		byte_buffer addr_buf(mmInfo.host_addr);
-		bdCommonAddr addr;
-		addr.deserialize(&addr_buf);
+		sessions.update(std::move(mmInfo));
 
 		auto reply = server->create_reply(this->get_sub_type());
 		reply->send();
 	}
 
-	void bdMatchMaking::delete_session(i_server* server, byte_buffer* buffer) const
+	void bdMatchMaking::delete_session(i_server* server, byte_buffer_view* buffer) const
 	{
 		bdSessionID id;
 		id.deserialize(buffer);
 
-		byte_buffer out_data;
-		id.serialize(&out_data);
+		sessions.remove(id.session_id);
 
 		auto reply = server->create_reply(this->get_sub_type());
 		reply->send();
 	}
 
-	void bdMatchMaking::get_performance(i_server* server, byte_buffer* /*buffer*/) const
+	void bdMatchMaking::get_performance(i_server* server, byte_buffer_view* /*buffer*/) const
 	{
 		auto* result = new bdPerformanceValue;
 		result->user_id = steam::SteamUser()->GetSteamID().bits;
@@ -93,13 +89,29 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdMatchMaking::find_sessions_two_pass(i_server* server, byte_buffer* /*buffer*/) const
+	void bdMatchMaking::find_sessions_two_pass(i_server* server, byte_buffer_view* /*buffer*/) const
 	{
 		auto reply = server->create_reply(this->get_sub_type());
 
-		for (auto& session : sessions)
+		// The layout of the search parameters is unknown, every live session except our own is returned
+		const auto own_session_id = steam::SteamUser()->GetSteamID().bits;
+
+		session_registry::query query{};
+		query.max_results = sessions_per_page;
+
+		while (true)
 		{
-			reply->add(session.second);
+			const auto result = sessions.find(query);
+			for (const auto& session : result.sessions)
+			{
+				if (session->session_id.session_id != own_session_id)
+				{
+					reply->add(session);
+				}
+			}
+
+			if (!result.has_more) break;
+			query.after_session_id = result.next_session_id;
 		}
 
 		reply->send();
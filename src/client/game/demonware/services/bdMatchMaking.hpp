@@ -9,10 +9,10 @@ namespace demonware
 		bdMatchMaking();
 
 	private:
-		void create_session(i_server* server, byte_buffer* buffer) const;
-		void update_session(i_server* server, byte_buffer* buffer) const;
-		void delete_session(i_server* server, byte_buffer* buffer) const;
-		void get_performance(i_server* server, byte_buffer* buffer) const;
-		void find_sessions_two_pass(i_server* server, byte_buffer* buffer) const;
+		void create_session(i_server* server, byte_buffer_view* buffer) const;
+		void update_session(i_server* server, byte_buffer_view* buffer) const;
+		void delete_session(i_server* server, byte_buffer_view* buffer) const;
+		void get_performance(i_server* server, byte_buffer_view* buffer) const;
+		void find_sessions_two_pass(i_server* server, byte_buffer_view* buffer) const;
 	};
 }
@@ -42,7 +42,7 @@ namespace demonware
 			buffer->set_use_data_types(true);
 		}
 
-		void deserialize(byte_buffer* /*buffer*/) override
+		void deserialize(byte_buffer_view* /*buffer*/) override
 		{
 		}
 	};
@@ -80,7 +80,7 @@ namespace demonware
 			buffer->set_use_data_types(true);
 		}
 
-		void deserialize(byte_buffer* /*buffer*/) override
+		void deserialize(byte_buffer_view* /*buffer*/) override
 		{
 		}
 	};
@@ -91,11 +91,11 @@ namespace demonware
 		this->register_service(4, &bdRelayService::get_credentials_from_ticket);
 	}
 
-	void bdRelayService::get_credentials(i_server* server, byte_buffer* buffer) const
+	void bdRelayService::get_credentials(i_server* server, byte_buffer_view* buffer) const
 	{
 		uint32_t unk1;
 		uint64_t user_id;
-		std::string platform;
+		std::string_view platform;
 
 		// User info.
 		buffer->read_uint32(&unk1);
@@ -114,9 +114,9 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdRelayService::get_credentials_from_ticket(i_server* server, byte_buffer* buffer) const
+	void bdRelayService::get_credentials_from_ticket(i_server* server, byte_buffer_view* buffer) const
 	{
-		std::string ticket;
+		std::string_view ticket;
 		buffer->read_string(&ticket);
 
 		auto* result = new DebugObjectUNO;
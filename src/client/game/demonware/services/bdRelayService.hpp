@@ -9,7 +9,7 @@ namespace demonware
 		bdRelayService();
 
 	private:
-		void get_credentials(i_server* server, byte_buffer* buffer) const;
-		void get_credentials_from_ticket(i_server* server, byte_buffer* buffer) const;
+		void get_credentials(i_server* server, byte_buffer_view* buffer) const;
+		void get_credentials_from_ticket(i_server* server, byte_buffer_view* buffer) const;
 	};
 }
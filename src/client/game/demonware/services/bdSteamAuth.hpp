@@ -6,6 +6,6 @@ namespace demonware
 	class bdSteamAuth final : public i_generic_service<28>
 	{
 	public:
-		void call_service(i_server* server, const std::string& data) override;
+		void call_service(i_server* server, std::string_view data) override;
 	};
 }
@@ -6,7 +6,6 @@
 #include <utils/compression.hpp>
 #include <utils/cryptography.hpp>
 #include <utils/nt.hpp>
-#include <utils/io.hpp>
 #include <utils/string.hpp>
 
 #include "component/motd.hpp"
@@ -33,7 +32,7 @@ namespace demonware
 		this->map_publisher_resource("social_[Tt][Uu][0-9]+\\.cfg", "dw/social_tu14.cfg", DW_SOCIAL_CONFIG);
 		this->map_publisher_resource("entitlement_config_[Tt][Uu][0-9]+\\.info", "dw/entitlement_config_tu14.info", DW_ENTITLEMENT_CONFIG);
 
-		publisher_resources_.emplace_back(std::regex{"heatmap\\.raw"}, generate_heat_map());
+		this->map_publisher_resource_variant("heatmap\\.raw", std::make_shared<const std::string>(generate_heat_map()));
 	}
 
 	void bdStorage::map_publisher_resource(const std::string& expression, const std::string& path, const int id)
@@ -42,7 +41,7 @@ namespace demonware
 			? filesystem::read_file(path)
 			: utils::nt::load_resource(id);
 
-		this->map_publisher_resource_variant(expression, std::move(data));
+		this->map_publisher_resource_variant(expression, std::make_shared<const std::string>(std::move(data)));
 	}
 
 	void bdStorage::map_publisher_resource_variant(const std::string& expression, resource_variant resource)
@@ -52,37 +51,66 @@ namespace demonware
 			throw std::runtime_error("Publisher resource variant is empty!");
 		}
 
-		this->publisher_resources_.emplace_back(std::regex{expression}, std::move(resource));
+		this->publisher_resources_.push_back({std::regex{expression, std::regex::optimize}, std::move(resource)});
+		this->resolved_resources_.clear();
 	}
 
-	bool bdStorage::load_publisher_resource(const std::string& name, std::string& buffer) const
+	const bdStorage::resolved_resource& bdStorage::resolve_publisher_resource(const std::string& name)
 	{
+		const auto entry = this->resolved_resources_.find(name);
+		if (entry != this->resolved_resources_.end())
+		{
+			return entry->second;
+		}
+
+		// Names come from the game and rarely vary, but don't let the cache grow unbounded
+		if (this->resolved_resources_.size() >= 1024)
+		{
+			this->resolved_resources_.clear();
+		}
+
+		resolved_resource resolved{nullptr, get_file_id(name)};
 		for (const auto& resource : this->publisher_resources_)
 		{
-			if (std::regex_match(name, resource.first))
+			if (std::regex_match(name, resource.expression))
 			{
-				if (std::holds_alternative<std::string>(resource.second))
-				{
-					buffer = std::get<std::string>(resource.second);
-				}
-				else
-				{
-					buffer = std::get<callback>(resource.second)();
-				}
-				return true;
+				resolved.resource = &resource;
+				break;
 			}
 		}
 
+		return this->resolved_resources_.emplace(name, resolved).first->second;
+	}
+
+	bdStorage::resource_data bdStorage::load_publisher_resource(const std::string& name, uint64_t* file_id)
+	{
+		const auto& resolved = this->resolve_publisher_resource(name);
+		if (!resolved.resource)
+		{
 #ifdef DEBUG
-		printf("[DW]: [bdStorage]: missing publisher file: %s\n", name.data());
+			printf("[DW]: [bdStorage]: missing publisher file: %s\n", name.data());
 #endif
 
-		return false;
+			return {};
+		}
+
+		if (file_id)
+		{
+			*file_id = resolved.file_id;
+		}
+
+		const auto& resource = resolved.resource->resource;
+		if (std::holds_alternative<resource_data>(resource))
+		{
+			return std::get<resource_data>(resource);
+		}
+
+		return std::make_shared<const std::string>(std::get<callback>(resource)());
 	}
 
-	std::string bdStorage::get_user_file_path(const std::string& name)
+	uint64_t bdStorage::get_file_id(const std::string& name)
 	{
-		return "players2/user/" + name;
+		return *reinterpret_cast<const uint64_t*>(utils::cryptography::sha1::compute(name).data());
 	}
 
 	std::string bdStorage::generate_heat_map()
@@ -107,26 +135,26 @@ namespace demonware
 			}
 		}
 
-		return utils::compression::zlib::compress(std::string(LPSTR(map), sizeof(map)));
+		return utils::compression::zlib::compress(std::string_view(LPSTR(map), sizeof(map)), utils::compression::zlib::default_compression);
 	}
 
-	void bdStorage::set_legacy_user_file(i_server* server, byte_buffer* buffer) const
+	void bdStorage::set_legacy_user_file(i_server* server, byte_buffer_view* buffer)
 	{
 		bool priv;
-		std::string filename, data;
+		std::string filename;
+		std::string_view data;
 
 		buffer->read_string(&filename);
 		buffer->read_bool(&priv);
 		buffer->read_blob(&data);
 
-		const auto id = *reinterpret_cast<const uint64_t*>(utils::cryptography::sha1::compute(filename).data());
+		const auto id = get_file_id(filename);
 		std::string id_string = utils::string::va("%llX", id);
 #ifdef DEBUG
 		printf("DW: Storing user file '%s' as %s\n", filename.data(), id_string.data());
 #endif
 
-		const auto path = get_user_file_path(id_string);
-		utils::io::write_file(path, data);
+		this->user_files_.store(id_string, std::string{data});
 
 		auto* info = new bdFileInfo;
 
@@ -143,10 +171,10 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdStorage::update_legacy_user_file(i_server* server, byte_buffer* buffer) const
+	void bdStorage::update_legacy_user_file(i_server* server, byte_buffer_view* buffer)
 	{
 		uint64_t id;
-		std::string data;
+		std::string_view data;
 
 		buffer->read_uint64(&id);
 		buffer->read_blob(&data);
@@ -156,8 +184,7 @@ namespace demonware
 		printf("DW: Updating user file %s\n", id_string.data());
 #endif
 
-		const auto path = get_user_file_path(id_string);
-		utils::io::write_file(path, data);
+		this->user_files_.store(id_string, std::string{data});
 
 		auto* info = new bdFileInfo;
 
@@ -174,22 +201,21 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdStorage::get_legacy_user_file(i_server* server, byte_buffer* buffer) const
+	void bdStorage::get_legacy_user_file(i_server* server, byte_buffer_view* buffer)
 	{
-		std::string filename, data;
+		std::string filename;
 		buffer->read_string(&filename);
 
-		const auto id = *reinterpret_cast<const uint64_t*>(utils::cryptography::sha1::compute(filename).data());
+		const auto id = get_file_id(filename);
 		std::string id_string = utils::string::va("%llX", id);
 #ifdef DEBUG
 		printf("DW: Loading user file: %s (%s)\n", filename.data(), id_string.data());
 #endif
 
-		const auto path = get_user_file_path(id_string);
-		if (utils::io::read_file(path, &data))
+		if (auto data = this->user_files_.load(id_string))
 		{
 			auto reply = server->create_reply(this->get_sub_type());
-			reply->add(new bdFileData(data));
+			reply->add(new bdFileData(std::move(data)));
 			reply->send();
 		}
 		else
@@ -198,12 +224,12 @@ namespace demonware
 		}
 	}
 
-	void bdStorage::list_legacy_user_files(i_server* server, byte_buffer* buffer) const
+	void bdStorage::list_legacy_user_files(i_server* server, byte_buffer_view* buffer)
 	{
 		uint64_t unk;
 		uint32_t date;
 		uint16_t num_results, offset;
-		std::string filename, data;
+		std::string filename;
 
 		buffer->read_uint64(&unk);
 		buffer->read_uint32(&date);
@@ -213,16 +239,15 @@ namespace demonware
 
 		auto reply = server->create_reply(this->get_sub_type());
 
-		const auto path = get_user_file_path(filename);
-		if (utils::io::read_file(path, &data))
+		if (const auto data = this->user_files_.load(filename))
 		{
 			auto* info = new bdFileInfo;
 
-			info->file_id = *reinterpret_cast<const uint64_t*>(utils::cryptography::sha1::compute(filename).data());
+			info->file_id = get_file_id(filename);
 			info->filename = filename;
 			info->create_time = 0;
 			info->modified_time = info->create_time;
-			info->file_size = uint32_t(data.size());
+			info->file_size = uint32_t(data->size());
 			info->owner_id = 0;
 			info->priv = false;
 
@@ -232,11 +257,11 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdStorage::list_publisher_files(i_server* server, byte_buffer* buffer)
+	void bdStorage::list_publisher_files(i_server* server, byte_buffer_view* buffer)
 	{
 		uint32_t date;
 		uint16_t num_results, offset;
-		std::string filename, data;
+		std::string filename;
 
 		buffer->read_uint32(&date);
 		buffer->read_uint16(&num_results);
@@ -245,15 +270,16 @@ namespace demonware
 
 		auto reply = server->create_reply(this->get_sub_type());
 
-		if (this->load_publisher_resource(filename, data))
+		uint64_t file_id{};
+		if (const auto data = this->load_publisher_resource(filename, &file_id))
 		{
 			auto* info = new bdFileInfo;
 
-			info->file_id = *reinterpret_cast<const uint64_t*>(utils::cryptography::sha1::compute(filename).data());
+			info->file_id = file_id;
 			info->filename = filename;
 			info->create_time = 0;
 			info->modified_time = info->create_time;
-			info->file_size = uint32_t(data.size());
+			info->file_size = uint32_t(data->size());
 			info->owner_id = 0;
 			info->priv = false;
 
@@ -263,7 +289,7 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdStorage::get_publisher_file(i_server* server, byte_buffer* buffer)
+	void bdStorage::get_publisher_file(i_server* server, byte_buffer_view* buffer)
 	{
 		std::string filename;
 		buffer->read_string(&filename);
@@ -272,14 +298,13 @@ namespace demonware
 		printf("[DW]: [bdStorage]: loading publisher file: %s\n", filename.data());
 #endif
 
-		std::string data;
-		if (this->load_publisher_resource(filename, data))
+		if (auto data = this->load_publisher_resource(filename))
 		{
 #ifdef DEBUG
-			printf("[DW]: [bdStorage]: sending publisher file: %s, size: %lld\n", filename.data(), data.size());
+			printf("[DW]: [bdStorage]: sending publisher file: %s, size: %lld\n", filename.data(), data->size());
 #endif
 			auto reply = server->create_reply(this->get_sub_type());
-			reply->add(new bdFileData(data));
+			reply->add(new bdFileData(std::move(data)));
 			reply->send();
 		}
 		else
@@ -288,10 +313,11 @@ namespace demonware
 		}
 	}
 
-	void bdStorage::delete_user_file(i_server* server, byte_buffer* buffer) const
+	void bdStorage::delete_user_file(i_server* server, byte_buffer_view* buffer) const
 	{
 		uint64_t owner;
-		std::string game, filename;
+		std::string_view game;
+		std::string filename;
 
 		buffer->read_string(&game);
 		buffer->read_string(&filename);
@@ -303,11 +329,13 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdStorage::set_user_file(i_server* server, byte_buffer* buffer) const
+	void bdStorage::set_user_file(i_server* server, byte_buffer_view* buffer)
 	{
 		bool priv;
 		uint64_t owner;
-		std::string game, filename, data;
+		std::string_view game;
+		std::string filename;
+		std::string_view data;
 
 		buffer->read_string(&game);
 		buffer->read_string(&filename);
@@ -315,12 +343,11 @@ namespace demonware
 		buffer->read_blob(&data);
 		buffer->read_uint64(&owner);
 
-		const auto path = get_user_file_path(filename);
-		utils::io::write_file(path, data);
+		this->user_files_.store(filename, std::string{data});
 
 		auto* info = new bdFileInfo;
 
-		info->file_id = *reinterpret_cast<const uint64_t*>(utils::cryptography::sha1::compute(filename).data());
+		info->file_id = get_file_id(filename);
 		info->filename = filename;
 		info->create_time = uint32_t(time(nullptr));
 		info->modified_time = info->create_time;
@@ -333,21 +360,21 @@ namespace demonware
 		reply->send();
 	}
 
-	void bdStorage::get_user_file(i_server* server, byte_buffer* buffer) const
+	void bdStorage::get_user_file(i_server* server, byte_buffer_view* buffer)
 	{
 		uint64_t owner{};
-		std::string game, filename, platform, data;
+		std::string_view game, platform;
+		std::string filename;
 
 		buffer->read_string(&game);
 		buffer->read_string(&filename);
 		buffer->read_uint64(&owner);
 		buffer->read_string(&platform);
 
-		const auto path = get_user_file_path(filename);
-		if (utils::io::read_file(path, &data))
+		if (auto data = this->user_files_.load(filename))
 		{
 			auto reply = server->create_reply(this->get_sub_type());
-			reply->add(new bdFileData(data));
+			reply->add(new bdFileData(std::move(data)));
 			reply->send();
 		}
 		else
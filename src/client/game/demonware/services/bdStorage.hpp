@@ -1,5 +1,6 @@
 #pragma once
 #include "../i_service.hpp"
+#include "../user_file_store.hpp"
 
 namespace demonware
 {
@@ -9,25 +10,45 @@ namespace demonware
 		bdStorage();
 
 	private:
+		using resource_data = std::shared_ptr<const std::string>;
 		using callback = std::function<std::string()>;
-		using resource_variant = std::variant<std::string, callback>;
-		std::vector<std::pair<std::regex, resource_variant>> publisher_resources_;
-
-		void set_legacy_user_file(i_server* server, byte_buffer* buffer) const;
-		void update_legacy_user_file(i_server* server, byte_buffer* buffer) const;
-		void get_legacy_user_file(i_server* server, byte_buffer* buffer) const;
-		void list_legacy_user_files(i_server* server, byte_buffer* buffer) const;
-		void list_publisher_files(i_server* server, byte_buffer* buffer);
-		void get_publisher_file(i_server* server, byte_buffer* buffer);
-		void delete_user_file(i_server* server, byte_buffer* buffer) const;
-		void set_user_file(i_server* server, byte_buffer* buffer) const;
-		void get_user_file(i_server* server, byte_buffer* buffer) const;
+		using resource_variant = std::variant<resource_data, callback>;
+
+		struct publisher_resource
+		{
+			std::regex expression;
+			resource_variant resource;
+		};
+
+		struct resolved_resource
+		{
+			const publisher_resource* resource;
+			uint64_t file_id;
+		};
+
+		std::vector<publisher_resource> publisher_resources_;
+
+		// Requested names resolved against publisher_resources_, including misses
+		std::unordered_map<std::string, resolved_resource> resolved_resources_;
+
+		user_file_store user_files_;
+
+		void set_legacy_user_file(i_server* server, byte_buffer_view* buffer);
+		void update_legacy_user_file(i_server* server, byte_buffer_view* buffer);
+		void get_legacy_user_file(i_server* server, byte_buffer_view* buffer);
+		void list_legacy_user_files(i_server* server, byte_buffer_view* buffer);
+		void list_publisher_files(i_server* server, byte_buffer_view* buffer);
+		void get_publisher_file(i_server* server, byte_buffer_view* buffer);
+		void delete_user_file(i_server* server, byte_buffer_view* buffer) const;
+		void set_user_file(i_server* server, byte_buffer_view* buffer);
+		void get_user_file(i_server* server, byte_buffer_view* buffer);
 
 		void map_publisher_resource(const std::string& expression, const std::string& path, int id);
 		void map_publisher_resource_variant(const std::string& expression, resource_variant resource);
-		bool load_publisher_resource(const std::string& name, std::string& buffer) const;
+		const resolved_resource& resolve_publisher_resource(const std::string& name);
+		resource_data load_publisher_resource(const std::string& name, uint64_t* file_id = nullptr);
 
-		static std::string get_user_file_path(const std::string& name);
+		static uint64_t get_file_id(const std::string& name);
 		static std::string generate_heat_map();
 	};
 }
@@ -9,7 +9,7 @@ namespace demonware
 		this->register_service(6, &bdTitleUtilities::get_server_time);
 	}
 
-	void bdTitleUtilities::get_server_time(i_server* server, byte_buffer* /*buffer*/) const
+	void bdTitleUtilities::get_server_time(i_server* server, byte_buffer_view* /*buffer*/) const
 	{
 		const auto time_result = new bdTimeStamp;
 		time_result->unix_time = uint32_t(time(nullptr));
@@ -9,6 +9,6 @@ namespace demonware
 		bdTitleUtilities();
 
 	private:
-		void get_server_time(i_server* server, byte_buffer* buffer) const;
+		void get_server_time(i_server* server, byte_buffer_view* buffer) const;
 	};
 }
@@ -0,0 +1,222 @@
+#include <std_include.hpp>
+#include "session_registry.hpp"
+
+namespace demonware
+{
+	void session_registry::update(session info)
+	{
+		if (!info)
+		{
+			return;
+		}
+
+		const auto session_id = info->session_id.session_id;
+		const auto now = clock::now();
+
+		std::unique_lock<std::shared_mutex> _(this->mutex_);
+		this->expire(now);
+
+		auto& entry = this->sessions_[session_id];
+		if (entry.info)
+		{
+			this->unindex(session_id, *entry.info);
+		}
+
+		entry.info = std::move(info);
+		entry.expires_at = now + session_ttl;
+
+		this->index(session_id, *entry.info);
+		this->expiry_queue_.emplace(entry.expires_at, session_id);
+	}
+
+	bool session_registry::remove(const uint64_t session_id)
+	{
+		std::unique_lock<std::shared_mutex> _(this->mutex_);
+		this->expire(clock::now());
+
+		const auto entry = this->sessions_.find(session_id);
+		if (entry == this->sessions_.end())
+		{
+			return false;
+		}
+
+		this->unindex(session_id, *entry->second.info);
+		this->sessions_.erase(entry);
+		return true;
+	}
+
+	session_registry::query_result session_registry::find(const query& query) const
+	{
+		static const std::set<uint64_t> no_sessions{};
+
+		query_result result{{}, query.after_session_id, false};
+		const auto now = clock::now();
+
+		std::shared_lock<std::shared_mutex> _(this->mutex_);
+
+		// Walk the smallest index that applies, the remaining filters are checked per session
+		const std::set<uint64_t>* candidates{};
+		const auto consider = [&candidates](const std::set<uint64_t>& index)
+		{
+			if (!candidates || index.size() < candidates->size())
+			{
+				candidates = &index;
+			}
+		};
+
+		if (query.playlist)
+		{
+			const auto index = this->by_playlist_.find(*query.playlist);
+			consider(index == this->by_playlist_.end() ? no_sessions : index->second);
+		}
+
+		if (query.game_type)
+		{
+			const auto index = this->by_game_type_.find(*query.game_type);
+			consider(index == this->by_game_type_.end() ? no_sessions : index->second);
+		}
+
+		const auto visit = [&](const uint64_t session_id, const record& entry)
+		{
+			if (entry.expires_at <= now || !matches(query, *entry.info))
+			{
+				return true;
+			}
+
+			if (result.sessions.size() >= query.max_results)
+			{
+				result.has_more = true;
+				return false;
+			}
+
+			result.sessions.push_back(entry.info);
+			result.next_session_id = session_id;
+			return true;
+		};
+
+		if (candidates)
+		{
+			for (auto i = candidates->upper_bound(query.after_session_id); i != candidates->end(); ++i)
+			{
+				if (!visit(*i, this->sessions_.at(*i))) break;
+			}
+		}
+		else if (query.min_free_slots > 0)
+		{
+			// Merge the matching free slot buckets in session id order, stopping as soon as the page is full
+			using cursor = std::pair<std::set<uint64_t>::const_iterator, std::set<uint64_t>::const_iterator>;
+			const auto is_later = [](const cursor& a, const cursor& b)
+			{
+				return *a.first > *b.first;
+			};
+
+			std::vector<cursor> cursors{};
+			for (auto i = this->by_free_slots_.lower_bound(query.min_free_slots); i != this->by_free_slots_.end(); ++i)
+			{
+				const auto begin = i->second.upper_bound(query.after_session_id);
+				if (begin != i->second.end())
+				{
+					cursors.emplace_back(begin, i->second.end());
+				}
+			}
+
+			std::ranges::make_heap(cursors, is_later);
+
+			while (!cursors.empty())
+			{
+				std::ranges::pop_heap(cursors, is_later);
+				auto& next = cursors.back();
+
+				const auto session_id = *next.first;
+				if (!visit(session_id, this->sessions_.at(session_id))) break;
+
+				if (++next.first == next.second)
+				{
+					cursors.pop_back();
+				}
+				else
+				{
+					std::ranges::push_heap(cursors, is_later);
+				}
+			}
+		}
+		else
+		{
+			for (auto i = this->sessions_.upper_bound(query.after_session_id); i != this->sessions_.end(); ++i)
+			{
+				if (!visit(i->first, i->second)) break;
+			}
+		}
+
+		return result;
+	}
+
+	size_t session_registry::size() const
+	{
+		std::shared_lock<std::shared_mutex> _(this->mutex_);
+		return this->sessions_.size();
+	}
+
+	void session_registry::expire()
+	{
+		std::unique_lock<std::shared_mutex> _(this->mutex_);
+		this->expire(clock::now());
+	}
+
+	void session_registry::expire(const clock::time_point now)
+	{
+		while (!this->expiry_queue_.empty() && this->expiry_queue_.top().first <= now)
+		{
+			const auto session_id = this->expiry_queue_.top().second;
+			this->expiry_queue_.pop();
+
+			const auto entry = this->sessions_.find(session_id);
+			if (entry != this->sessions_.end() && entry->second.expires_at <= now)
+			{
+				this->unindex(session_id, *entry->second.info);
+				this->sessions_.erase(entry);
+			}
+		}
+	}
+
+	void session_registry::index(const uint64_t session_id, const MatchMakingInfo& info)
+	{
+		this->by_playlist_[info.playlist_number].insert(session_id);
+		this->by_game_type_[info.game_type].insert(session_id);
+		this->by_free_slots_[get_free_slots(info)].insert(session_id);
+	}
+
+	void session_registry::unindex(const uint64_t session_id, const MatchMakingInfo& info)
+	{
+		const auto erase = [session_id](auto& index, const auto& key)
+		{
+			const auto entry = index.find(key);
+			if (entry == index.end())
+			{
+				return;
+			}
+
+			entry->second.erase(session_id);
+			if (entry->second.empty())
+			{
+				index.erase(entry);
+			}
+		};
+
+		erase(this->by_playlist_, info.playlist_number);
+		erase(this->by_game_type_, info.game_type);
+		erase(this->by_free_slots_, get_free_slots(info));
+	}
+
+	uint32_t session_registry::get_free_slots(const MatchMakingInfo& info)
+	{
+		return info.max_players > info.num_players ? info.max_players - info.num_players : 0;
+	}
+
+	bool session_registry::matches(const query& query, const MatchMakingInfo& info)
+	{
+		if (query.playlist && info.playlist_number != *query.playlist) return false;
+		if (query.game_type && info.game_type != *query.game_type) return false;
+		return get_free_slots(info) >= query.min_free_slots;
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "data_types.hpp"
+
+namespace demonware
+{
+	// In-process matchmaking session store.
+	// Sessions are indexed by playlist, game type and free slots and expire when their host stops updating them.
+	class session_registry final
+	{
+	public:
+		using session = std::shared_ptr<MatchMakingInfo>;
+		using clock = std::chrono::steady_clock;
+
+		static constexpr auto session_ttl = 10min;
+
+		struct query
+		{
+			std::optional<int32_t> playlist{};
+			std::optional<uint32_t> game_type{};
+			uint32_t min_free_slots = 0;
+
+			// Paging cursor, only sessions with a greater id are returned
+			uint64_t after_session_id = 0;
+			size_t max_results = std::numeric_limits<size_t>::max();
+		};
+
+		struct query_result
+		{
+			std::vector<session> sessions;
+			uint64_t next_session_id;
+			bool has_more;
+		};
+
+		void update(session info);
+		bool remove(uint64_t session_id);
+
+		query_result find(const query& query) const;
+		size_t size() const;
+
+		void expire();
+
+	private:
+		struct record
+		{
+			session info;
+			clock::time_point expires_at;
+		};
+
+		mutable std::shared_mutex mutex_;
+
+		std::map<uint64_t, record> sessions_;
+		std::unordered_map<int32_t, std::set<uint64_t>> by_playlist_;
+		std::unordered_map<uint32_t, std::set<uint64_t>> by_game_type_;
+		std::map<uint32_t, std::set<uint64_t>> by_free_slots_;
+
+		// Lazily cleaned, an entry is stale once the record got refreshed or removed
+		std::priority_queue<std::pair<clock::time_point, uint64_t>, std::vector<std::pair<clock::time_point, uint64_t>>,
+		                    std::greater<>> expiry_queue_;
+
+		void index(uint64_t session_id, const MatchMakingInfo& info);
+		void unindex(uint64_t session_id, const MatchMakingInfo& info);
+		void expire(clock::time_point now);
+
+		static uint32_t get_free_slots(const MatchMakingInfo& info);
+		static bool matches(const query& query, const MatchMakingInfo& info);
+	};
+}
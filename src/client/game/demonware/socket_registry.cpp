@@ -0,0 +1,212 @@
+#include <std_include.hpp>
+#include "socket_registry.hpp"
+
+namespace demonware
+{
+	socket_registry::socket_registry() : slots_(std::make_unique<slot[]>(capacity))
+	{
+		this->table_ = this->slots_.get();
+	}
+
+	size_t socket_registry::hash(const SOCKET s)
+	{
+		// Socket handles are multiples of 4, drop the low bits before mixing
+		return static_cast<size_t>((static_cast<uint64_t>(s) >> 2) * 0x9E3779B97F4A7C15ull) & (capacity - 1);
+	}
+
+	size_t socket_registry::next(const size_t index)
+	{
+		return (index + 1) & (capacity - 1);
+	}
+
+	size_t socket_registry::previous(const size_t index)
+	{
+		return (index - 1) & (capacity - 1);
+	}
+
+	const socket_registry::slot* socket_registry::find(const SOCKET s) const
+	{
+		const auto* table = this->table_.load(std::memory_order_acquire);
+
+		auto index = hash(s);
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			const auto& entry = table[index];
+			const auto current = entry.socket.load(std::memory_order_acquire);
+
+			if (current == s) return &entry;
+			if (current == empty_slot) break;
+
+			index = next(index);
+		}
+
+		return nullptr;
+	}
+
+	uint32_t socket_registry::get_flags(const SOCKET s) const
+	{
+		this->active_readers_.fetch_add(1);
+		const auto _ = gsl::finally([this]()
+		{
+			this->active_readers_.fetch_sub(1);
+		});
+
+		while (true)
+		{
+			const auto* entry = this->find(s);
+			if (!entry)
+			{
+				this->untracked_lookups_.fetch_add(1, std::memory_order_relaxed);
+				return 0;
+			}
+
+			const auto flags = entry->flags.load(std::memory_order_acquire);
+
+			// The slot may have been erased and reused for another socket between the probe and the flags read
+			if (entry->socket.load(std::memory_order_acquire) == s)
+			{
+				this->tracked_lookups_.fetch_add(1, std::memory_order_relaxed);
+				return flags;
+			}
+		}
+	}
+
+	bool socket_registry::is_tracked(const SOCKET s, const uint32_t mask) const
+	{
+		return (this->get_flags(s) & mask) != 0;
+	}
+
+	bool socket_registry::set_flags(const SOCKET s, const uint32_t set, const uint32_t clear)
+	{
+		if (s == empty_slot || s == deleted_slot) return false;
+
+		auto* existing = const_cast<slot*>(this->find(s));
+		if (existing)
+		{
+			const auto flags = (existing->flags.load(std::memory_order_relaxed) & ~clear) | set;
+			existing->flags.store(flags, std::memory_order_release);
+			return true;
+		}
+
+		if (!set) return true;
+
+		auto index = hash(s);
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			auto& entry = this->slots_[index];
+			const auto current = entry.socket.load(std::memory_order_relaxed);
+
+			if (current == empty_slot || current == deleted_slot)
+			{
+				if (current == deleted_slot)
+				{
+					--this->tombstones_;
+				}
+
+				// Publish the flags before the key so readers never see a stale value
+				entry.flags.store(set, std::memory_order_release);
+				entry.socket.store(s, std::memory_order_release);
+				++this->entries_;
+				return true;
+			}
+
+			index = next(index);
+		}
+
+		return false;
+	}
+
+	void socket_registry::erase(const SOCKET s)
+	{
+		auto* entry = const_cast<slot*>(this->find(s));
+		if (!entry) return;
+
+		entry->socket.store(deleted_slot, std::memory_order_release);
+		entry->flags.store(0, std::memory_order_release);
+		--this->entries_;
+		++this->tombstones_;
+
+		this->sweep(static_cast<size_t>(entry - this->slots_.get()));
+
+		if (this->tombstones_ >= rebuild_threshold)
+		{
+			this->rebuild();
+		}
+		else
+		{
+			this->reclaim();
+		}
+	}
+
+	void socket_registry::sweep(size_t index)
+	{
+		// A tombstone right before an empty slot ends every probe chain through it, so it can become empty.
+		// Readers racing this only ever see a shorter chain that still holds all live sockets.
+		while (this->slots_[index].socket.load(std::memory_order_relaxed) == deleted_slot
+			&& this->slots_[next(index)].socket.load(std::memory_order_relaxed) == empty_slot)
+		{
+			this->slots_[index].socket.store(empty_slot, std::memory_order_release);
+			--this->tombstones_;
+
+			index = previous(index);
+		}
+	}
+
+	void socket_registry::rebuild()
+	{
+		auto slots = std::make_unique<slot[]>(capacity);
+
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			const auto& entry = this->slots_[i];
+			const auto s = entry.socket.load(std::memory_order_relaxed);
+			if (s == empty_slot || s == deleted_slot) continue;
+
+			auto index = hash(s);
+			while (slots[index].socket.load(std::memory_order_relaxed) != empty_slot)
+			{
+				index = next(index);
+			}
+
+			slots[index].flags.store(entry.flags.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			slots[index].socket.store(s, std::memory_order_relaxed);
+		}
+
+		this->retired_slots_.emplace_back(std::move(this->slots_));
+		this->slots_ = std::move(slots);
+		this->tombstones_ = 0;
+
+		this->table_.store(this->slots_.get());
+		this->reclaim();
+	}
+
+	void socket_registry::reclaim()
+	{
+		// Sequentially consistent with the reader count, a lookup that is not counted yet will load the new table
+		if (!this->retired_slots_.empty() && this->active_readers_.load() == 0)
+		{
+			this->retired_slots_.clear();
+		}
+	}
+
+	void socket_registry::clear()
+	{
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			this->slots_[i].socket.store(empty_slot, std::memory_order_release);
+			this->slots_[i].flags.store(0, std::memory_order_release);
+		}
+
+		this->entries_ = 0;
+		this->tombstones_ = 0;
+	}
+
+	socket_registry::statistics socket_registry::get_statistics() const
+	{
+		statistics stats{};
+		stats.untracked_lookups = this->untracked_lookups_.load(std::memory_order_relaxed);
+		stats.tracked_lookups = this->tracked_lookups_.load(std::memory_order_relaxed);
+		stats.entries = this->entries_.load(std::memory_order_relaxed);
+		return stats;
+	}
+}
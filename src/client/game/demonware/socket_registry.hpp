@@ -0,0 +1,73 @@
+#pragma once
+
+namespace demonware
+{
+	// Flat open-addressing table of the sockets demonware cares about.
+	// Lookups are lock-free so foreign sockets can skip the server lock,
+	// writers must be serialized by the caller.
+	class socket_registry final
+	{
+	public:
+		enum flag : uint32_t
+		{
+			linked = 1 << 0,
+			datagram = 1 << 1,
+			blocking_set = 1 << 2,
+			blocking = 1 << 3,
+		};
+
+		struct statistics
+		{
+			uint64_t untracked_lookups;
+			uint64_t tracked_lookups;
+			uint64_t entries;
+		};
+
+		socket_registry();
+
+		uint32_t get_flags(SOCKET s) const;
+		bool is_tracked(SOCKET s, uint32_t mask) const;
+
+		bool set_flags(SOCKET s, uint32_t set, uint32_t clear = 0);
+		void erase(SOCKET s);
+		void clear();
+
+		statistics get_statistics() const;
+
+	private:
+		static constexpr size_t capacity = 4096;
+		static constexpr SOCKET empty_slot = INVALID_SOCKET;
+		static constexpr SOCKET deleted_slot = INVALID_SOCKET - 1;
+
+		// Tombstones only get reused by inserts that probe over them, past this many the table is rebuilt
+		static constexpr size_t rebuild_threshold = capacity / 4;
+
+		struct slot
+		{
+			std::atomic<SOCKET> socket{empty_slot};
+			std::atomic<uint32_t> flags{0};
+		};
+
+		std::atomic<slot*> table_{};
+		std::unique_ptr<slot[]> slots_;
+		std::atomic<size_t> entries_{0};
+		size_t tombstones_ = 0;
+
+		// Tables replaced by a rebuild. They are only freed once a writer sees no lookup in flight,
+		// every lookup starting after that point can only have loaded the current table.
+		std::vector<std::unique_ptr<slot[]>> retired_slots_;
+		mutable std::atomic<size_t> active_readers_{0};
+
+		mutable std::atomic<uint64_t> untracked_lookups_{0};
+		mutable std::atomic<uint64_t> tracked_lookups_{0};
+
+		static size_t hash(SOCKET s);
+		static size_t next(size_t index);
+		static size_t previous(size_t index);
+
+		const slot* find(SOCKET s) const;
+		void sweep(size_t index);
+		void rebuild();
+		void reclaim();
+	};
+}
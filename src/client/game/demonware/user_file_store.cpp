@@ -0,0 +1,227 @@
+#include <std_include.hpp>
+#include "user_file_store.hpp"
+
+#include <utils/io.hpp>
+#include <utils/thread.hpp>
+
+namespace demonware
+{
+	user_file_store::user_file_store()
+	{
+		this->writer_thread_ = utils::thread::create_named_thread("DW User Files", [this]()
+		{
+			this->writer();
+		});
+	}
+
+	user_file_store::~user_file_store()
+	{
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			this->terminate_ = true;
+		}
+
+		this->condition_.notify_one();
+
+		if (this->writer_thread_.joinable())
+		{
+			this->writer_thread_.join();
+		}
+	}
+
+	void user_file_store::store(const std::string& name, std::string data)
+	{
+		auto file = std::make_shared<const std::string>(std::move(data));
+
+		std::lock_guard<std::mutex> _(this->mutex_);
+
+		const auto entry = this->entries_.find(name);
+		if (entry != this->entries_.end())
+		{
+			this->cached_bytes_ -= entry->second.data->size();
+			this->cached_bytes_ += file->size();
+
+			entry->second.data = std::move(file);
+			this->touch(entry->second);
+
+			if (!entry->second.dirty)
+			{
+				entry->second.dirty = true;
+				++this->dirty_count_;
+			}
+		}
+		else
+		{
+			this->insert(name, std::move(file), true);
+		}
+
+		this->evict();
+		this->condition_.notify_one();
+	}
+
+	user_file_store::file_data user_file_store::load(const std::string& name)
+	{
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+
+			const auto entry = this->entries_.find(name);
+			if (entry != this->entries_.end())
+			{
+				this->touch(entry->second);
+				return entry->second.data;
+			}
+		}
+
+		std::string data{};
+		if (!utils::io::read_file(get_path(name), &data))
+		{
+			return {};
+		}
+
+		auto file = std::make_shared<const std::string>(std::move(data));
+
+		std::lock_guard<std::mutex> _(this->mutex_);
+
+		// A store might have raced the read, it is newer than what's on disk
+		const auto entry = this->entries_.find(name);
+		if (entry != this->entries_.end())
+		{
+			this->touch(entry->second);
+			return entry->second.data;
+		}
+
+		this->insert(name, file, false);
+		this->evict();
+
+		return file;
+	}
+
+	void user_file_store::flush()
+	{
+		std::lock_guard<std::mutex> write_lock(this->write_mutex_);
+
+		std::vector<std::pair<std::string, file_data>> pending{};
+
+		{
+			std::lock_guard<std::mutex> _(this->mutex_);
+			pending.reserve(this->dirty_count_);
+
+			for (auto& [name, entry] : this->entries_)
+			{
+				if (entry.dirty)
+				{
+					entry.dirty = false;
+					pending.emplace_back(name, entry.data);
+				}
+			}
+
+			this->dirty_count_ = 0;
+		}
+
+		for (const auto& [name, data] : pending)
+		{
+			if (write_file(get_path(name), *data))
+			{
+				continue;
+			}
+
+#ifdef DEBUG
+			printf("DW: Failed to write user file %s\n", name.data());
+#endif
+
+			// Keep the data around so the next flush retries it
+			std::lock_guard<std::mutex> _(this->mutex_);
+
+			const auto entry = this->entries_.find(name);
+			if (entry != this->entries_.end() && !entry->second.dirty)
+			{
+				entry->second.dirty = true;
+				++this->dirty_count_;
+			}
+		}
+	}
+
+	void user_file_store::writer()
+	{
+		std::unique_lock<std::mutex> lock(this->mutex_);
+
+		while (!this->terminate_)
+		{
+			this->condition_.wait(lock, [this]()
+			{
+				return this->terminate_ || this->dirty_count_ > 0;
+			});
+
+			// Give the game a moment to finish its burst of saves so they coalesce into one write
+			this->condition_.wait_for(lock, flush_delay, [this]()
+			{
+				return this->terminate_;
+			});
+
+			lock.unlock();
+			this->flush();
+			lock.lock();
+		}
+	}
+
+	void user_file_store::touch(entry& file)
+	{
+		this->lru_.splice(this->lru_.begin(), this->lru_, file.position);
+	}
+
+	void user_file_store::insert(const std::string& name, file_data data, const bool dirty)
+	{
+		this->lru_.push_front(name);
+		this->cached_bytes_ += data->size();
+
+		if (dirty)
+		{
+			++this->dirty_count_;
+		}
+
+		this->entries_.emplace(name, entry{std::move(data), this->lru_.begin(), dirty});
+	}
+
+	void user_file_store::evict()
+	{
+		// Dirty entries stay pinned until the writer got them on disk
+		auto position = this->lru_.end();
+		while (this->cached_bytes_ > max_cached_bytes && position != this->lru_.begin())
+		{
+			--position;
+
+			const auto entry = this->entries_.find(*position);
+			if (entry->second.dirty)
+			{
+				continue;
+			}
+
+			this->cached_bytes_ -= entry->second.data->size();
+			this->entries_.erase(entry);
+			position = this->lru_.erase(position);
+		}
+	}
+
+	std::string user_file_store::get_path(const std::string& name)
+	{
+		return "players2/user/" + name;
+	}
+
+	bool user_file_store::write_file(const std::string& path, const std::string& data)
+	{
+		// Write next to the target and swap it in, a crash mid-write must not leave a truncated profile behind
+		const auto temp_path = path + ".tmp";
+		if (!utils::io::write_file(temp_path, data))
+		{
+			return false;
+		}
+
+		if (!MoveFileExA(temp_path.data(), path.data(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+		{
+			utils::io::remove_file(temp_path);
+			return false;
+		}
+
+		return true;
+	}
+}
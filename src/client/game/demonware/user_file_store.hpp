@@ -0,0 +1,58 @@
+#pragma once
+
+namespace demonware
+{
+	// Write-behind cache in front of players2/user/.
+	// Stores are kept in memory and flushed by a background thread,
+	// loads are served from the cache and read through on a miss.
+	class user_file_store final
+	{
+	public:
+		using file_data = std::shared_ptr<const std::string>;
+
+		user_file_store();
+		~user_file_store();
+
+		user_file_store(user_file_store&&) = delete;
+		user_file_store(const user_file_store&) = delete;
+		user_file_store& operator=(user_file_store&&) = delete;
+		user_file_store& operator=(const user_file_store&) = delete;
+
+		void store(const std::string& name, std::string data);
+		file_data load(const std::string& name);
+
+		void flush();
+
+	private:
+		static constexpr size_t max_cached_bytes = 16 * 1024 * 1024;
+		static constexpr auto flush_delay = 2s;
+
+		struct entry
+		{
+			file_data data;
+			std::list<std::string>::iterator position;
+			bool dirty;
+		};
+
+		std::mutex mutex_;
+		std::mutex write_mutex_;
+		std::condition_variable condition_;
+
+		std::unordered_map<std::string, entry> entries_;
+		std::list<std::string> lru_;
+		size_t cached_bytes_ = 0;
+		size_t dirty_count_ = 0;
+
+		bool terminate_ = false;
+		std::thread writer_thread_;
+
+		void writer();
+
+		void touch(entry& file);
+		void insert(const std::string& name, file_data data, bool dirty);
+		void evict();
+
+		static std::string get_path(const std::string& name);
+		static bool write_file(const std::string& path, const std::string& data);
+	};
+}
@@ -9,5 +9,8 @@ namespace scripting
 		std::string name;
 		entity entity{};
 		std::vector<script_value> arguments;
+
+		// Set for notifies coming from the VM, the engine copies the arguments off its stack only if a listener needs them
+		game::VariableValue* top = nullptr;
 	};
 }
@@ -5,6 +5,8 @@
 
 #include "component/scripting.hpp"
 
+#include <utils/string.hpp>
+
 namespace scripting
 {
 	namespace
@@ -24,7 +26,12 @@ namespace scripting
 			game::AddRefToValue(value_ptr->type, value_ptr->u);
 		}
 
-		int get_field_id(const int classnum, const std::string& field)
+		using field_id_cache = std::unordered_map<std::string, int, utils::string::transparent_hash, std::equal_to<>>;
+
+		// Per entity class, misses are cached as well since they are custom fields
+		std::unordered_map<int, field_id_cache> field_ids;
+
+		int find_field_id(const int classnum, const std::string& field)
 		{
 			const auto class_id = game::g_classMap[classnum].id;
 			const auto field_str = game::SL_GetString(field.data(), 0);
@@ -44,6 +51,19 @@ namespace scripting
 			return -1;
 		}
 
+		int get_field_id(const int classnum, const std::string& field)
+		{
+			auto& cache = field_ids[classnum];
+			if (const auto itr = cache.find(field); itr != cache.end())
+			{
+				return itr->second;
+			}
+
+			const auto id = find_field_id(classnum, field);
+			cache.emplace(field, id);
+			return id;
+		}
+
 		script_value get_return_value()
 		{
 			if (game::scr_VmPub->inparamcount == 0)
@@ -57,6 +77,40 @@ namespace scripting
 
 			return script_value(game::scr_VmPub->top[1 - game::scr_VmPub->outparamcount]);
 		}
+
+		bool is_method_call(const game::scr_entref_t entref)
+		{
+			return *reinterpret_cast<const int*>(&entref) != -1;
+		}
+
+		script_value invoke_function(const script_function function, const std::string& name, const entity& entity,
+		                             const std::vector<script_value>& arguments)
+		{
+			const auto entref = entity.get_entity_reference();
+			const auto method_call = is_method_call(entref);
+
+			if (function == nullptr)
+			{
+				throw std::runtime_error("Unknown "s + (method_call ? "method" : "function") + " '" + name + "'");
+			}
+
+			stack_isolation _;
+
+			for (auto i = arguments.rbegin(); i != arguments.rend(); ++i)
+			{
+				push_value(*i);
+			}
+
+			game::scr_VmPub->outparamcount = game::scr_VmPub->inparamcount;
+			game::scr_VmPub->inparamcount = 0;
+
+			if (!safe_execution::call(function, entref))
+			{
+				throw std::runtime_error("Error executing "s + (method_call ? "method" : "function") + " '" + name + "'");
+			}
+
+			return get_return_value();
+		}
 	}
 
 	void notify(const entity& entity, const std::string& event, const std::vector<script_value>& arguments)
@@ -71,34 +125,23 @@ namespace scripting
 		game::Scr_NotifyId(entity.get_entity_id(), event_id, game::scr_VmPub->inparamcount);
 	}
 
+	resolved_function resolve_function(const std::string& name)
+	{
+		return {name, find_function(name, true), find_function(name, false)};
+	}
+
 	script_value call_function(const std::string& name, const entity& entity,
 	                           const std::vector<script_value>& arguments)
 	{
-		const auto entref = entity.get_entity_reference();
-
-		const auto is_method_call = *reinterpret_cast<const int*>(&entref) != -1;
-		const auto function = find_function(name, !is_method_call);
-		if (function == nullptr)
-		{
-			throw std::runtime_error("Unknown "s + (is_method_call ? "method" : "function") + " '" + name + "'");
-		}
-
-		stack_isolation _;
-
-		for (auto i = arguments.rbegin(); i != arguments.rend(); ++i)
-		{
-			push_value(*i);
-		}
-
-		game::scr_VmPub->outparamcount = game::scr_VmPub->inparamcount;
-		game::scr_VmPub->inparamcount = 0;
-
-		if (!safe_execution::call(function, entref))
-		{
-			throw std::runtime_error("Error executing "s + (is_method_call ? "method" : "function") + " '" + name + "'");
-		}
+		const auto function = find_function(name, !is_method_call(entity.get_entity_reference()));
+		return invoke_function(function, name, entity, arguments);
+	}
 
-		return get_return_value();
+	script_value call_function(const resolved_function& function, const entity& entity,
+	                           const std::vector<script_value>& arguments)
+	{
+		const auto method_call = is_method_call(entity.get_entity_reference());
+		return invoke_function(method_call ? function.method : function.function, function.name, entity, arguments);
 	}
 
 	script_value call_function(const std::string& name, const std::vector<script_value>& arguments)
@@ -154,42 +197,122 @@ namespace scripting
 		return exec_ent_thread(entity, pos, arguments);
 	}
 
-	static std::unordered_map<unsigned int, std::unordered_map<std::string, script_value>> custom_fields;
+	namespace
+	{
+		// Field names are interned into slots, every object keeps a dense row of values indexed by slot.
+		// Game entities use a row per entity number, any other object a sparse row keyed by its id.
+		// Rows only grow when a field is set, unset slots hold undefined.
+		struct custom_field_table
+		{
+			using row = std::vector<script_value>;
+
+			std::unordered_map<std::string, size_t, utils::string::transparent_hash, std::equal_to<>> slots;
+			std::vector<row> entities;
+			std::unordered_map<unsigned int, row> objects;
+		};
+
+		custom_field_table custom_fields;
+
+		std::optional<unsigned short> get_entity_number(const entity& entity)
+		{
+			const auto id = entity.get_entity_id();
+			if (!id || game::scr_VarGlob->objectVariableValue[id].w.type != game::VAR_ENTITY)
+			{
+				return {};
+			}
+
+			const auto entref = entity.get_entity_reference();
+			if (entref.classnum != 0)
+			{
+				return {};
+			}
+
+			return entref.entnum;
+		}
+
+		custom_field_table::row* find_custom_field_row(const entity& entity)
+		{
+			if (const auto entnum = get_entity_number(entity))
+			{
+				return *entnum < custom_fields.entities.size() ? &custom_fields.entities[*entnum] : nullptr;
+			}
+
+			const auto row = custom_fields.objects.find(entity.get_entity_id());
+			return row == custom_fields.objects.end() ? nullptr : &row->second;
+		}
+
+		custom_field_table::row& get_custom_field_row(const entity& entity)
+		{
+			if (const auto entnum = get_entity_number(entity))
+			{
+				if (*entnum >= custom_fields.entities.size())
+				{
+					custom_fields.entities.resize(*entnum + 1);
+				}
+
+				return custom_fields.entities[*entnum];
+			}
+
+			return custom_fields.objects[entity.get_entity_id()];
+		}
+
+		const script_value* find_custom_field(const entity& entity, const std::string& field)
+		{
+			const auto slot = custom_fields.slots.find(field);
+			if (slot == custom_fields.slots.end())
+			{
+				return nullptr;
+			}
+
+			const auto* row = find_custom_field_row(entity);
+			return row && slot->second < row->size() ? &(*row)[slot->second] : nullptr;
+		}
+	}
 
 	script_value get_custom_field(const entity& entity, const std::string& field)
 	{
-		auto fields = custom_fields[entity.get_entity_id()];
-
-		const auto itr = fields.find(field);
-		return itr == fields.end() ? script_value() : itr->second;
+		const auto* value = find_custom_field(entity, field);
+		return value ? *value : script_value();
 	}
 
 	void set_custom_field(const entity& entity, const std::string& field, const script_value& value)
 	{
-		const auto id = entity.get_entity_id();
+		auto slot = custom_fields.slots.find(field);
+		if (slot == custom_fields.slots.end())
+		{
+			slot = custom_fields.slots.emplace(field, custom_fields.slots.size()).first;
+		}
 
-		if (custom_fields[id].contains(field))
+		auto& row = get_custom_field_row(entity);
+		if (slot->second >= row.size())
 		{
-			custom_fields[id][field] = value;
-			return;
+			row.resize(slot->second + 1);
 		}
 
-		custom_fields[id].insert(std::make_pair(field, value));
+		row[slot->second] = value;
 	}
 
 	void clear_entity_fields(const entity& entity)
 	{
-		const auto id = entity.get_entity_id();
-
-		if (custom_fields.contains(id))
+		if (get_entity_number(entity))
 		{
-			custom_fields[id].clear();
+			// Releases the references held by the values, the row keeps its capacity for the next entity in that slot
+			if (auto* row = find_custom_field_row(entity))
+			{
+				row->clear();
+			}
+
+			return;
 		}
+
+		custom_fields.objects.erase(entity.get_entity_id());
 	}
 
 	void clear_custom_fields()
 	{
-		custom_fields.clear();
+		custom_fields.slots.clear();
+		custom_fields.entities = {};
+		custom_fields.objects = {};
 	}
 
 	void set_entity_field(const entity& entity, const std::string& field, const script_value& value)
@@ -217,6 +340,11 @@ namespace scripting
 		}
 	}
 
+	void clear_field_cache()
+	{
+		field_ids.clear();
+	}
+
 	script_value get_entity_field(const entity& entity, const std::string& field)
 	{
 		const auto entref = entity.get_entity_reference();
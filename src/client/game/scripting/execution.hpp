@@ -1,11 +1,23 @@
 #pragma once
 #include "entity.hpp"
+#include "functions.hpp"
 #include "script_value.hpp"
 
 namespace scripting
 {
+	// Both variants are resolved up front, the entity decides at call time which one runs
+	struct resolved_function
+	{
+		std::string name;
+		script_function function;
+		script_function method;
+	};
+
+	resolved_function resolve_function(const std::string& name);
+
 	script_value call_function(const std::string& name, const std::vector<script_value>& arguments);
 	script_value call_function(const std::string& name, const entity& entity, const std::vector<script_value>& arguments);
+	script_value call_function(const resolved_function& function, const entity& entity, const std::vector<script_value>& arguments);
 
 	template <typename T = script_value>
 	T call(const std::string& name, const std::vector<script_value>& arguments = {});
@@ -28,6 +40,7 @@ namespace scripting
 
 	void set_entity_field(const entity& entity, const std::string& field, const script_value& value);
 	script_value get_entity_field(const entity& entity, const std::string& field);
+	void clear_field_cache();
 
 	void notify(const entity& entity, const std::string& event, const std::vector<script_value>& arguments);
 }
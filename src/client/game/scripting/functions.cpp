@@ -12,6 +12,11 @@ namespace scripting
 {
 	namespace
 	{
+		using function_cache = std::unordered_map<std::string, script_function, utils::string::transparent_hash, std::equal_to<>>;
+
+		// Indexed by prefer_global, unknown names are not cached
+		function_cache resolved_functions[2];
+
 		int find_function_index(const std::string& name, const bool prefer_global)
 		{
 			const auto target = utils::string::to_lower(name);
@@ -90,9 +95,25 @@ namespace scripting
 
 	script_function find_function(const std::string& name, const bool prefer_global)
 	{
+		auto& cache = resolved_functions[prefer_global ? 1 : 0];
+		if (const auto itr = cache.find(name); itr != cache.end())
+		{
+			return itr->second;
+		}
+
 		const auto index = find_function_index(name, prefer_global);
 		if (index < 0) return nullptr;
 
-		return get_function_by_index(index);
+		const auto function = get_function_by_index(index);
+		cache.emplace(name, function);
+		return function;
+	}
+
+	void clear_function_cache()
+	{
+		for (auto& cache : resolved_functions)
+		{
+			cache.clear();
+		}
 	}
 }
@@ -11,4 +11,5 @@ namespace scripting
 
 	script_function get_function_by_index(std::uint32_t index);
 	script_function find_function(const std::string& name, bool prefer_global);
+	void clear_function_cache();
 }
@@ -66,10 +66,39 @@ namespace scripting::lua
 			return result;
 		}
 
-		const std::vector<std::string>& get_game_constants()
+		using name_set = std::unordered_set<std::string, utils::string::transparent_hash, std::equal_to<>>;
+		using method_map = std::unordered_map<std::string, std::optional<resolved_function>, utils::string::transparent_hash, std::equal_to<>>;
+
+		bool is_game_constant(const std::string& name)
 		{
-			static auto constants = load_game_constants();
-			return constants;
+			// Disassembled once per process, on the first entity field lookup
+			static const auto constants = []
+			{
+				const auto list = load_game_constants();
+				return name_set(list.begin(), list.end());
+			}();
+
+			return constants.contains(name);
+		}
+
+		// Shared by every context, names that aren't methods are remembered as well
+		const std::optional<resolved_function>& find_method(const std::string& name)
+		{
+			static method_map methods{};
+
+			auto method = methods.find(name);
+			if (method == methods.end())
+			{
+				std::optional<resolved_function> resolved{};
+				if (xsk::gsc::iw6::resolver::method_id(name))
+				{
+					resolved = resolve_function(name);
+				}
+
+				method = methods.emplace(name, std::move(resolved)).first;
+			}
+
+			return method->second;
 		}
 
 		void setup_entity_type(sol::state& state, event_handler& handler, scheduler& scheduler)
@@ -87,34 +116,6 @@ namespace scripting::lua
 
 			auto entity_type = state.new_usertype<entity>("entity");
 
-			for (const auto& func : xsk::gsc::iw6::resolver::get_methods())
-			{
-				const auto name = std::string(func.first);
-				entity_type[name] = [name](const entity& entity, const sol::this_state s, sol::variadic_args va)
-				{
-					std::vector<script_value> arguments{};
-
-					for (auto arg : va)
-					{
-						arguments.push_back(convert({s, arg}));
-					}
-
-					return convert(s, entity.call(name, arguments));
-				};
-			}
-
-			for (const auto& constant : get_game_constants())
-			{
-				entity_type[constant] = sol::property([constant](const entity& entity, const sol::this_state s)
-				{
-					return convert(s, entity.get(constant));
-				},
-				[constant](const entity& entity, const sol::this_state s, const sol::lua_value& value)
-				{
-						entity.set(constant, convert({s, value}));
-				});
-			}
-
 			entity_type["set"] = [](const entity& entity, const std::string& field, const sol::lua_value& value)
 			{
 				entity.set(field, convert(value));
@@ -177,9 +178,34 @@ namespace scripting::lua
 				entity.set(field, convert(value));
 			};
 
+			// Methods are bound on first use, game constants are fields even if a method shares their name
 			entity_type[sol::meta_function::index] = [](const entity& entity, const sol::this_state s, const std::string& field)
 			{
-				return convert(s, entity.get(field));
+				if (!is_game_constant(field))
+				{
+					if (const auto& method = find_method(field))
+					{
+						auto function = [method = *method](const scripting::entity& entity, const sol::this_state s, sol::variadic_args va)
+						{
+							std::vector<script_value> arguments{};
+
+							for (auto arg : va)
+							{
+								arguments.push_back(convert({s, arg}));
+							}
+
+							return convert(s, call_function(method, entity, arguments));
+						};
+
+						// Later lookups find the member directly and skip this handler
+						sol::usertype<scripting::entity> type = sol::state_view(s)["entity"];
+						type[field] = function;
+
+						return sol::make_object(s, function);
+					}
+				}
+
+				return sol::make_object(s, convert(s, entity.get(field)));
 			};
 
 			entity_type["struct"] = sol::property([](const entity& entity, const sol::this_state s)
@@ -215,8 +241,8 @@ namespace scripting::lua
 
 			for (const auto& func : xsk::gsc::iw6::resolver::get_functions())
 			{
-				const auto name = std::string(func.first);
-				game_type[name] = [name](const game&, const sol::this_state s, sol::variadic_args va)
+				const auto function = resolve_function(std::string(func.first));
+				game_type[function.name] = [function](const game&, const sol::this_state s, sol::variadic_args va)
 				{
 					std::vector<script_value> arguments{};
 
@@ -225,7 +251,7 @@ namespace scripting::lua
 						arguments.push_back(convert({s, arg}));
 					}
 
-					return convert(s, call(name, arguments));
+					return convert(s, call_function(function, entity(), arguments));
 				};
 			}
 
@@ -450,6 +476,11 @@ namespace scripting::lua
 		this->event_handler_.dispatch(e);
 	}
 
+	bool context::has_listeners(const event& e)
+	{
+		return this->event_handler_.has_listeners(e);
+	}
+
 	void context::collect_garbage()
 	{
 		this->state_.collect_garbage();
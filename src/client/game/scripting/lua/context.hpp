@@ -29,6 +29,7 @@ namespace scripting::lua
 
 		void run_frame();
 		void notify(const event& e);
+		bool has_listeners(const event& e);
 		void collect_garbage();
 
 	private:
@@ -8,11 +8,19 @@
 #include "component/game_module.hpp"
 
 #include <utils/io.hpp>
+#include <utils/concurrency.hpp>
+#include <utils/string.hpp>
 
 namespace scripting::lua::engine
 {
 	namespace
 	{
+		using notify_interest_set = std::unordered_set<std::string, utils::string::transparent_hash, std::equal_to<>>;
+
+		// Interests only grow while the scripts are loaded, stale ones merely cost a dispatch
+		utils::concurrency::container<notify_interest_set> notify_interests;
+		std::atomic_bool has_notify_interests = false;
+
 		auto& get_scripts()
 		{
 			static std::vector<std::unique_ptr<context>> scripts{};
@@ -42,6 +50,12 @@ namespace scripting::lua::engine
 	{
 		notifies::clear_callbacks();
 		get_scripts().clear();
+
+		notify_interests.access([](notify_interest_set& interests)
+		{
+			interests.clear();
+			has_notify_interests = false;
+		});
 	}
 
 	void start()
@@ -60,9 +74,36 @@ namespace scripting::lua::engine
 
 	void notify(const event& e)
 	{
+		if (!e.top)
+		{
+			for (auto& script : get_scripts())
+			{
+				script->notify(e);
+			}
+
+			return;
+		}
+
+		// Callbacks can run script code that reuses the VM stack, so it is read once before any of them run.
+		// Without a listener only endon conditions fire and they need no arguments.
+		event copy{};
+		copy.name = e.name;
+		copy.entity = e.entity;
+
+		if (std::ranges::any_of(get_scripts(), [&](const std::unique_ptr<context>& script)
+		{
+			return script->has_listeners(e);
+		}))
+		{
+			for (auto* value = e.top; value->type != game::VAR_PRECODEPOS; --value)
+			{
+				copy.arguments.emplace_back(*value);
+			}
+		}
+
 		for (auto& script : get_scripts())
 		{
-			script->notify(e);
+			script->notify(copy);
 		}
 	}
 
@@ -73,4 +114,26 @@ namespace scripting::lua::engine
 			script->run_frame();
 		}
 	}
+
+	void add_notify_interest(const std::string& event)
+	{
+		notify_interests.access([&](notify_interest_set& interests)
+		{
+			interests.emplace(event);
+			has_notify_interests = true;
+		});
+	}
+
+	bool is_notify_interesting(const std::string_view event)
+	{
+		if (!has_notify_interests)
+		{
+			return false;
+		}
+
+		return notify_interests.access<bool>([&](const notify_interest_set& interests)
+		{
+			return interests.contains(event);
+		});
+	}
 }
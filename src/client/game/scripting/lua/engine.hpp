@@ -8,4 +8,8 @@ namespace scripting::lua::engine
 	void stop();
 	void notify(const event& e);
 	void run_frame();
+
+	// Only events a listener or endon condition was registered for are worth dispatching
+	void add_notify_interest(const std::string& event);
+	bool is_notify_interesting(std::string_view event);
 }
@@ -4,9 +4,15 @@
 #include "value_conversion.hpp"
 
 #include "event_handler.hpp"
+#include "engine.hpp"
 
 namespace scripting::lua
 {
+	namespace
+	{
+		constexpr size_t compaction_threshold = 64;
+	}
+
 	event_handler::event_handler(sol::state& state)
 		: state_(state)
 	{
@@ -28,48 +34,97 @@ namespace scripting::lua
 		bool has_built_arguments = false;
 		event_arguments arguments{};
 
-		callbacks_.access([&](task_list& tasks)
+		callbacks_.access([&](listener_index& index)
 		{
 			this->merge_callbacks();
-			this->handle_endon_conditions(event);
 
-			for (auto i = tasks.begin(); i != tasks.end();)
+			const auto event_id = find_event_id(index, event.name);
+			if (!event_id)
 			{
-				if (i->event != event.name || i->entity != event.entity)
+				return;
+			}
+
+			const auto key = get_key(event.entity, *event_id);
+			this->handle_endon_conditions(index, key);
+
+			auto bucket = index.listeners.find(key);
+			if (bucket == index.listeners.end())
+			{
+				return;
+			}
+
+			++index.dispatch_depth;
+			const auto _ = gsl::finally([&]()
+			{
+				--index.dispatch_depth;
+			});
+
+			// Listeners added while dispatching only see the next event
+			const auto count = bucket->second.size();
+			for (size_t i = 0; i < count; ++i)
+			{
+				// Callbacks can modify the index, so look the bucket up again every time
+				bucket = index.listeners.find(key);
+				if (bucket == index.listeners.end() || i >= bucket->second.size())
 				{
-					++i;
-					continue;
+					break;
 				}
 
-				if (!i->is_deleted)
+				const auto listener = bucket->second[i];
+				if (listener->is_deleted)
 				{
-					if(!has_built_arguments)
-					{
-						has_built_arguments = true;
-						arguments = this->build_arguments(event);
-					}
-					
-					handle_error(i->callback(sol::as_args(arguments)));
+					continue;
 				}
 
-				if (i->is_volatile || i->is_deleted)
+				if (listener->is_volatile)
 				{
-					i = tasks.erase(i);
+					mark_as_deleted(index, *listener);
 				}
-				else
+
+				if (!has_built_arguments)
 				{
-					++i;
+					has_built_arguments = true;
+					arguments = this->build_arguments(event);
 				}
+
+				handle_error(listener->callback(sol::as_args(arguments)));
+			}
+
+			if (index.dispatch_depth == 1)
+			{
+				this->compact(index, key);
 			}
 		});
 	}
 
+	bool event_handler::has_listeners(const event& event)
+	{
+		return callbacks_.access<bool>([&](listener_index& index)
+		{
+			this->merge_callbacks();
+
+			const auto event_id = find_event_id(index, event.name);
+			if (!event_id)
+			{
+				return false;
+			}
+
+			const auto bucket = index.listeners.find(get_key(event.entity, *event_id));
+			return bucket != index.listeners.end() && std::ranges::any_of(bucket->second, [](const auto& listener)
+			{
+				return !listener->is_deleted;
+			});
+		});
+	}
+
 	event_listener_handle event_handler::add_event_listener(event_listener&& listener)
 	{
 		const std::uint64_t id = ++this->current_listener_id_;
 		listener.id = id;
 		listener.is_deleted = false;
 
+		engine::add_notify_interest(listener.event);
+
 		new_callbacks_.access([&listener](task_list& tasks)
 		{
 			tasks.emplace_back(std::move(listener));
@@ -81,39 +136,63 @@ namespace scripting::lua
 	void event_handler::add_endon_condition(const event_listener_handle& handle, const entity& entity,
 			const std::string& event)
 	{
-		auto merger = [&](task_list& tasks)
+		engine::add_notify_interest(event);
+
+		callbacks_.access([&](listener_index& index)
 		{
-			for(auto& task : tasks)
+			if (index.active.contains(handle.id))
 			{
-				if(task.id == handle.id)
+				this->add_endon_condition(index, handle.id, entity, event);
+				return;
+			}
+
+			new_callbacks_.access([&](task_list& tasks)
+			{
+				for (auto& task : tasks)
 				{
-					task.endon_conditions.emplace_back(entity, event);
+					if (task.id == handle.id)
+					{
+						task.endon_conditions.emplace_back(entity, event);
+					}
 				}
-			}
-		};
-		
-		callbacks_.access([&](task_list& tasks)
-		{
-			merger(tasks);
-			new_callbacks_.access(merger);
+			});
 		});
 	}
 
+	void event_handler::add_endon_condition(listener_index& index, const std::uint64_t id, const entity& entity,
+	                                        const std::string& event)
+	{
+		const auto key = get_key(entity, get_event_id(index, event));
+		index.endon_conditions[key].push_back(id);
+	}
+
 	void event_handler::clear()
 	{
-		callbacks_.access([&](task_list& tasks)
+		callbacks_.access([&](listener_index& index)
 		{
 			new_callbacks_.access([&](task_list& new_tasks)
 			{
 				new_tasks.clear();
-				tasks.clear();
+				index.listeners.clear();
+				index.endon_conditions.clear();
+				index.active.clear();
+				index.tombstones = 0;
 			});
 		});
 	}
 
 	void event_handler::remove(const event_listener_handle& handle)
 	{
-		auto mask_as_deleted = [&](task_list& tasks)
+		callbacks_.access([&](listener_index& index)
+		{
+			const auto listener = index.active.find(handle.id);
+			if (listener != index.active.end())
+			{
+				mark_as_deleted(index, *listener->second);
+			}
+		});
+
+		new_callbacks_.access([&](task_list& tasks)
 		{
 			for (auto& task : tasks)
 			{
@@ -123,42 +202,153 @@ namespace scripting::lua
 					break;
 				}
 			}
-		};
-
-		callbacks_.access(mask_as_deleted);
-		new_callbacks_.access(mask_as_deleted);
+		});
 	}
 
 	void event_handler::merge_callbacks()
 	{
-		callbacks_.access([&](task_list& tasks)
+		callbacks_.access([&](listener_index& index)
 		{
 			new_callbacks_.access([&](task_list& new_tasks)
 			{
-				tasks.insert(tasks.end(), std::move_iterator(new_tasks.begin()), std::move_iterator(new_tasks.end()));
+				for (auto& task : new_tasks)
+				{
+					if (task.is_deleted)
+					{
+						continue;
+					}
+
+					const auto id = task.id;
+					const auto key = get_key(task.entity, get_event_id(index, task.event));
+					const auto conditions = std::move(task.endon_conditions);
+
+					auto listener = std::make_shared<event_listener>(std::move(task));
+					index.listeners[key].push_back(listener);
+					index.active.emplace(id, std::move(listener));
+
+					for (const auto& [entity, event] : conditions)
+					{
+						this->add_endon_condition(index, id, entity, event);
+					}
+				}
+
 				new_tasks = {};
 			});
 		});
 	}
 
-	void event_handler::handle_endon_conditions(const event& event)
+	void event_handler::handle_endon_conditions(listener_index& index, const listener_key key)
 	{
-		auto deleter = [&](task_list& tasks)
+		const auto conditions = index.endon_conditions.find(key);
+		if (conditions == index.endon_conditions.end())
 		{
-			for (auto& task : tasks)
+			return;
+		}
+
+		// Every listener waiting on this condition ends now, so the entry can go
+		const auto ids = std::move(conditions->second);
+		index.endon_conditions.erase(conditions);
+
+		for (const auto id : ids)
+		{
+			const auto listener = index.active.find(id);
+			if (listener != index.active.end())
 			{
-				for (auto& condition : task.endon_conditions)
-				{
-					if (condition.first == event.entity && condition.second == event.name)
-					{
-						task.is_deleted = true;
-						break;
-					}
-				}
+				mark_as_deleted(index, *listener->second);
 			}
-		};
+		}
+	}
+
+	void event_handler::compact(listener_index& index, const listener_key key)
+	{
+		const auto bucket = index.listeners.find(key);
+		if (bucket != index.listeners.end())
+		{
+			index.tombstones -= std::erase_if(bucket->second, [](const std::shared_ptr<event_listener>& listener)
+			{
+				return listener->is_deleted;
+			});
+
+			if (bucket->second.empty())
+			{
+				index.listeners.erase(bucket);
+			}
+		}
+
+		if (index.tombstones < compaction_threshold || index.tombstones < index.active.size())
+		{
+			return;
+		}
+
+		for (auto i = index.listeners.begin(); i != index.listeners.end();)
+		{
+			std::erase_if(i->second, [](const std::shared_ptr<event_listener>& listener)
+			{
+				return listener->is_deleted;
+			});
+
+			if (i->second.empty())
+			{
+				i = index.listeners.erase(i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+
+		for (auto i = index.endon_conditions.begin(); i != index.endon_conditions.end();)
+		{
+			std::erase_if(i->second, [&](const std::uint64_t id)
+			{
+				return !index.active.contains(id);
+			});
+
+			if (i->second.empty())
+			{
+				i = index.endon_conditions.erase(i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+
+		index.tombstones = 0;
+	}
+
+	event_handler::listener_key event_handler::get_key(const entity& entity, const std::uint32_t event_id)
+	{
+		return (static_cast<listener_key>(entity.get_entity_id()) << 32) | event_id;
+	}
+
+	std::optional<std::uint32_t> event_handler::find_event_id(const listener_index& index, const std::string& event)
+	{
+		const auto entry = index.event_ids.find(event);
+		if (entry == index.event_ids.end())
+		{
+			return {};
+		}
+
+		return entry->second;
+	}
+
+	std::uint32_t event_handler::get_event_id(listener_index& index, const std::string& event)
+	{
+		const auto id = static_cast<std::uint32_t>(index.event_ids.size());
+		return index.event_ids.emplace(event, id).first->second;
+	}
+
+	void event_handler::mark_as_deleted(listener_index& index, event_listener& listener)
+	{
+		if (listener.is_deleted)
+		{
+			return;
+		}
 
-		callbacks_.access(deleter);
+		listener.is_deleted = true;
+		index.active.erase(listener.id);
+		++index.tombstones;
 	}
 
 	event_arguments event_handler::build_arguments(const event& event) const
@@ -35,6 +35,7 @@ namespace scripting::lua
 		event_handler& operator=(const event_handler&) = delete;
 
 		void dispatch(const event& event);
+		bool has_listeners(const event& event);
 
 		event_listener_handle add_event_listener(event_listener&& listener);
 
@@ -44,15 +45,37 @@ namespace scripting::lua
 		sol::state& state_;
 		std::atomic_int64_t current_listener_id_ = 0;
 
+		// Listeners and endon conditions are bucketed by (entity id, interned event id),
+		// removed listeners stay in their bucket as tombstones until compacted
+		using listener_key = std::uint64_t;
+		using listener_list = std::vector<std::shared_ptr<event_listener>>;
+
+		struct listener_index
+		{
+			std::unordered_map<std::string, std::uint32_t> event_ids;
+			std::unordered_map<listener_key, listener_list> listeners;
+			std::unordered_map<listener_key, std::vector<std::uint64_t>> endon_conditions;
+			std::unordered_map<std::uint64_t, std::shared_ptr<event_listener>> active;
+			size_t tombstones = 0;
+			size_t dispatch_depth = 0;
+		};
+
 		using task_list = std::vector<event_listener>;
 		utils::concurrency::container<task_list> new_callbacks_;
-		utils::concurrency::container<task_list, std::recursive_mutex> callbacks_;
+		utils::concurrency::container<listener_index, std::recursive_mutex> callbacks_;
 
 		void remove(const event_listener_handle& handle);
 		void merge_callbacks();
-		void handle_endon_conditions(const event& event);
+		void handle_endon_conditions(listener_index& index, listener_key key);
+		void compact(listener_index& index, listener_key key);
 
 		void add_endon_condition(const event_listener_handle& handle, const entity& entity, const std::string& event);
+		void add_endon_condition(listener_index& index, std::uint64_t id, const entity& entity, const std::string& event);
+
+		static listener_key get_key(const entity& entity, std::uint32_t event_id);
+		static std::optional<std::uint32_t> find_event_id(const listener_index& index, const std::string& event);
+		static std::uint32_t get_event_id(listener_index& index, const std::string& event);
+		static void mark_as_deleted(listener_index& index, event_listener& listener);
 
 		event_arguments build_arguments(const event& event) const;
 	};
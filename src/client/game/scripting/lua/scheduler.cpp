@@ -1,6 +1,7 @@
 #include "std_include.hpp"
 #include "context.hpp"
 #include "error.hpp"
+#include "engine.hpp"
 
 namespace scripting::lua
 {
@@ -21,72 +22,123 @@ namespace scripting::lua
 
 	void scheduler::dispatch(const event& event)
 	{
-		auto deleter = [&](task_list& tasks)
+		callbacks_.access([&](task_queue& queue)
 		{
-			for(auto& task : tasks)
+			const auto conditions = queue.endon_conditions.find(event.name);
+			if (conditions != queue.endon_conditions.end())
 			{
-				for(auto& condition : task.endon_conditions)
+				const auto entity_id = event.entity.get_entity_id();
+				std::erase_if(conditions->second, [&](const std::pair<unsigned int, uint64_t>& condition)
 				{
-					if(condition.first == event.entity && condition.second == event.name)
+					if (condition.first != entity_id)
 					{
-						task.is_deleted = true;
-						break;
+						return false;
 					}
+
+					this->remove(queue, condition.second);
+					--queue.endon_count;
+					return true;
+				});
+
+				if (conditions->second.empty())
+				{
+					queue.endon_conditions.erase(conditions);
 				}
 			}
-		};
-		
-		callbacks_.access([&](task_list& tasks)
-		{
-			deleter(tasks);
-			new_callbacks_.access(deleter);
+
+			new_callbacks_.access([&](task_list& tasks)
+			{
+				for (auto& task : tasks)
+				{
+					for (auto& condition : task.endon_conditions)
+					{
+						if (condition.first == event.entity && condition.second == event.name)
+						{
+							task.is_deleted = true;
+							break;
+						}
+					}
+				}
+			});
 		});
 	}
 
 	void scheduler::run_frame()
 	{
-		callbacks_.access([&](task_list& tasks)
+		callbacks_.access([&](task_queue& queue)
 		{
 			this->merge_callbacks();
 
-			for (auto i = tasks.begin(); i != tasks.end();)
+			const auto now = std::chrono::steady_clock::now();
+			std::vector<deadline> rescheduled{};
+
+			while (!queue.deadlines.empty() && queue.deadlines.front().first <= now)
 			{
-				const auto now = std::chrono::high_resolution_clock::now();
-				const auto diff = now - i->last_call;
+				std::ranges::pop_heap(queue.deadlines, std::greater{});
+				const auto id = queue.deadlines.back().second;
+				queue.deadlines.pop_back();
 
-				if (diff < i->delay)
+				const auto entry = queue.tasks.find(id);
+				if (entry == queue.tasks.end())
 				{
-					++i;
 					continue;
 				}
 
-				i->last_call = now;
+				entry->second.last_call = now;
+
+				if (!entry->second.is_deleted)
+				{
+					queue.running_task = id;
+					const auto _ = gsl::finally([&]()
+					{
+						queue.running_task = 0;
+					});
+
+					const auto callback = entry->second.callback;
+					handle_error(callback());
+				}
 
-				if (!i->is_deleted)
+				// The callback might have cleared the scheduler
+				const auto task = queue.tasks.find(id);
+				if (task == queue.tasks.end())
 				{
-					handle_error(i->callback());
+					continue;
 				}
 
-				if (i->is_volatile || i->is_deleted)
+				if (task->second.is_volatile || task->second.is_deleted)
 				{
-					i = tasks.erase(i);
+					queue.tasks.erase(task);
 				}
 				else
 				{
-					++i;
+					rescheduled.emplace_back(now + task->second.delay, id);
 				}
 			}
+
+			// Pushed afterwards so zero-delay tasks run once per frame
+			for (const auto& [time, id] : rescheduled)
+			{
+				push_deadline(queue, time, id);
+			}
+
+			if (queue.endon_count > (queue.tasks.size() * 2) + 64)
+			{
+				collect_endon_conditions(queue);
+			}
 		});
 	}
 
 	void scheduler::clear()
 	{
-		callbacks_.access([&](task_list& tasks)
+		callbacks_.access([&](task_queue& queue)
 		{
 			new_callbacks_.access([&](task_list& new_tasks)
 			{
 				new_tasks.clear();
-				tasks.clear();
+				queue.tasks.clear();
+				queue.deadlines.clear();
+				queue.endon_conditions.clear();
+				queue.endon_count = 0;
 			});
 		});
 	}
@@ -120,27 +172,38 @@ namespace scripting::lua
 
 	void scheduler::add_endon_condition(const task_handle& handle, const entity& entity, const std::string& event)
 	{
-		auto merger = [&](task_list& tasks)
+		engine::add_notify_interest(event);
+
+		callbacks_.access([&](task_queue& queue)
 		{
-			for(auto& task : tasks)
+			if (queue.tasks.contains(handle.id))
+			{
+				queue.endon_conditions[event].emplace_back(entity.get_entity_id(), handle.id);
+				++queue.endon_count;
+				return;
+			}
+
+			new_callbacks_.access([&](task_list& tasks)
 			{
-				if(task.id == handle.id)
+				for (auto& task : tasks)
 				{
-					task.endon_conditions.emplace_back(entity, event);
+					if (task.id == handle.id)
+					{
+						task.endon_conditions.emplace_back(entity, event);
+					}
 				}
-			}
-		};
-		
-		callbacks_.access([&](task_list& tasks)
-		{
-			merger(tasks);
-			new_callbacks_.access(merger);
+			});
 		});
 	}
 
 	void scheduler::remove(const task_handle& handle)
 	{
-		auto mask_as_deleted = [&](task_list& tasks)
+		callbacks_.access([&](task_queue& queue)
+		{
+			this->remove(queue, handle.id);
+		});
+
+		new_callbacks_.access([&](task_list& tasks)
 		{
 			for (auto& task : tasks)
 			{
@@ -150,22 +213,82 @@ namespace scripting::lua
 					break;
 				}
 			}
-		};
+		});
+	}
+
+	void scheduler::remove(task_queue& queue, const uint64_t id)
+	{
+		// The running task is still executing, it gets dropped once its callback returns
+		if (queue.running_task == id)
+		{
+			const auto entry = queue.tasks.find(id);
+			if (entry != queue.tasks.end())
+			{
+				entry->second.is_deleted = true;
+			}
+
+			return;
+		}
 
-		callbacks_.access(mask_as_deleted);
-		new_callbacks_.access(mask_as_deleted);
+		queue.tasks.erase(id);
 	}
 
 	void scheduler::merge_callbacks()
 	{
-		callbacks_.access([&](task_list& tasks)
+		callbacks_.access([&](task_queue& queue)
 		{
 			new_callbacks_.access([&](task_list& new_tasks)
 			{
-				tasks.insert(tasks.end(), std::move_iterator<task_list::iterator>(new_tasks.begin()),
-				             std::move_iterator<task_list::iterator>(new_tasks.end()));
+				for (auto& task : new_tasks)
+				{
+					if (task.is_deleted)
+					{
+						continue;
+					}
+
+					const auto id = task.id;
+					for (const auto& [entity, event] : task.endon_conditions)
+					{
+						queue.endon_conditions[event].emplace_back(entity.get_entity_id(), id);
+						++queue.endon_count;
+					}
+
+					push_deadline(queue, task.last_call + task.delay, id);
+					queue.tasks.emplace(id, std::move(task));
+				}
+
 				new_tasks = {};
 			});
 		});
 	}
+
+	void scheduler::collect_endon_conditions(task_queue& queue)
+	{
+		queue.endon_count = 0;
+
+		for (auto i = queue.endon_conditions.begin(); i != queue.endon_conditions.end();)
+		{
+			std::erase_if(i->second, [&](const std::pair<unsigned int, uint64_t>& condition)
+			{
+				return !queue.tasks.contains(condition.second);
+			});
+
+			queue.endon_count += i->second.size();
+
+			if (i->second.empty())
+			{
+				i = queue.endon_conditions.erase(i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	void scheduler::push_deadline(task_queue& queue, const std::chrono::steady_clock::time_point time, const uint64_t id)
+	{
+		queue.deadlines.emplace_back(time, id);
+		std::ranges::push_heap(queue.deadlines, std::greater{});
+	}
 }
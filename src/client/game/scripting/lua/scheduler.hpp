@@ -42,13 +42,30 @@ namespace scripting::lua
 
 	private:
 		using task_list = std::vector<task>;
+		using deadline = std::pair<std::chrono::steady_clock::time_point, uint64_t>;
+
+		// Tasks are owned by id, a min-heap of deadlines decides what runs next.
+		// Heap entries of removed tasks are skipped when they come up.
+		struct task_queue
+		{
+			std::unordered_map<uint64_t, task> tasks;
+			std::vector<deadline> deadlines;
+			std::unordered_map<std::string, std::vector<std::pair<unsigned int, uint64_t>>> endon_conditions;
+			size_t endon_count = 0;
+			uint64_t running_task = 0;
+		};
+
 		utils::concurrency::container<task_list> new_callbacks_;
-		utils::concurrency::container<task_list, std::recursive_mutex> callbacks_;
+		utils::concurrency::container<task_queue, std::recursive_mutex> callbacks_;
 		std::atomic_int64_t current_task_id_ = 0;
 
 		void add_endon_condition(const task_handle& handle, const entity& entity, const std::string& event);
 
 		void remove(const task_handle& handle);
+		void remove(task_queue& queue, uint64_t id);
 		void merge_callbacks();
+
+		static void collect_endon_conditions(task_queue& queue);
+		static void push_deadline(task_queue& queue, std::chrono::steady_clock::time_point time, uint64_t id);
 	};
 }
@@ -61,11 +61,14 @@
 #endif
 
 #include <atomic>
+#include <charconv>
 #include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <functional>
+#include <list>
 #include <map>
 #include <mutex>
 #include <optional>
@@ -73,6 +76,9 @@
 #include <random>
 #include <ranges>
 #include <regex>
+#include <set>
+#include <shared_mutex>
+#include <source_location>
 #include <sstream>
 #include <string>
 #include <thread>
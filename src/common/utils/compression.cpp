@@ -6,6 +6,11 @@
 
 #include <gsl/gsl>
 
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
 #include "io.hpp"
 
 namespace utils::compression
@@ -14,21 +19,23 @@ namespace utils::compression
 	{
 		namespace
 		{
-			class zlib_stream
+			constexpr size_t max_stream_size = std::numeric_limits<uInt>::max();
+
+			class inflater
 			{
 			public:
-				zlib_stream()
+				inflater()
 				{
 					memset(&stream_, 0, sizeof(stream_));
 					valid_ = inflateInit(&stream_) == Z_OK;
 				}
 
-				zlib_stream(zlib_stream&&) = delete;
-				zlib_stream(const zlib_stream&) = delete;
-				zlib_stream& operator=(zlib_stream&&) = delete;
-				zlib_stream& operator=(const zlib_stream&) = delete;
+				inflater(inflater&&) = delete;
+				inflater(const inflater&) = delete;
+				inflater& operator=(inflater&&) = delete;
+				inflater& operator=(const inflater&) = delete;
 
-				~zlib_stream()
+				~inflater()
 				{
 					if (valid_)
 					{
@@ -36,78 +43,262 @@ namespace utils::compression
 					}
 				}
 
-				z_stream& get()
+				z_stream* begin()
 				{
-					return stream_; //
+					if (!valid_ || inflateReset(&stream_) != Z_OK)
+					{
+						return nullptr;
+					}
+
+					return &stream_;
 				}
 
-				bool is_valid() const
+			private:
+				bool valid_{false};
+				z_stream stream_{};
+			};
+
+			class deflater
+			{
+			public:
+				deflater() = default;
+
+				deflater(deflater&&) = delete;
+				deflater(const deflater&) = delete;
+				deflater& operator=(deflater&&) = delete;
+				deflater& operator=(const deflater&) = delete;
+
+				~deflater()
 				{
-					return valid_;
+					this->end();
+				}
+
+				z_stream* begin(const int level)
+				{
+					if (valid_ && level_ == level)
+					{
+						return deflateReset(&stream_) == Z_OK ? &stream_ : nullptr;
+					}
+
+					this->end();
+
+					memset(&stream_, 0, sizeof(stream_));
+					valid_ = deflateInit(&stream_, level) == Z_OK;
+					level_ = level;
+
+					return valid_ ? &stream_ : nullptr;
 				}
 
 			private:
 				bool valid_{false};
+				int level_{};
 				z_stream stream_{};
+
+				void end()
+				{
+					if (valid_)
+					{
+						deflateEnd(&stream_);
+						valid_ = false;
+					}
+				}
 			};
+
+			// Streams are reset instead of rebuilt, so every thread keeps its own
+			inflater& get_inflater()
+			{
+				static thread_local inflater inflater{};
+				return inflater;
+			}
+
+			deflater& get_deflater()
+			{
+				static thread_local deflater deflater{};
+				return deflater;
+			}
+
+			void set_input(z_stream& stream, const std::string_view data, size_t& offset)
+			{
+				const auto input_size = std::min(max_stream_size, data.size() - offset);
+				stream.avail_in = static_cast<uInt>(input_size);
+				stream.next_in = reinterpret_cast<const Bytef*>(data.data()) + offset;
+				offset += input_size;
+			}
 		}
 
-		std::string decompress(const std::string& data)
+		std::string decompress(const std::string_view data, const size_t size_hint)
 		{
-			std::string buffer{};
-			zlib_stream stream_container{};
-			if (!stream_container.is_valid())
+			auto* stream = get_inflater().begin();
+			if (!stream)
 			{
 				return {};
 			}
 
+			std::string buffer{};
+			buffer.resize(size_hint ? size_hint : std::max(static_cast<size_t>(CHUNK), data.size() * 4));
+
+			int ret{};
+			size_t input_offset = 0;
+			size_t output_offset = 0;
+
+			do
+			{
+				if (!stream->avail_in && input_offset < data.size())
+				{
+					set_input(*stream, data, input_offset);
+				}
+
+				// Inflate straight into the result and only grow it once the hint turns out too small
+				if (output_offset == buffer.size())
+				{
+					buffer.resize(buffer.size() * 2);
+				}
+
+				const auto output_size = std::min(max_stream_size, buffer.size() - output_offset);
+				stream->avail_out = static_cast<uInt>(output_size);
+				stream->next_out = reinterpret_cast<Bytef*>(buffer.data()) + output_offset;
+
+				ret = inflate(stream, Z_NO_FLUSH);
+				output_offset += output_size - stream->avail_out;
+
+				if (ret == Z_BUF_ERROR && !stream->avail_in && input_offset == data.size())
+				{
+					return {}; // Truncated input
+				}
+
+				if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+				{
+					return {};
+				}
+			}
+			while (ret != Z_STREAM_END);
+
+			buffer.resize(output_offset);
+			return buffer;
+		}
+
+		bool decompress(const std::string_view data, const chunk_callback& callback)
+		{
+			auto* stream = get_inflater().begin();
+			if (!stream)
+			{
+				return false;
+			}
+
 			int ret{};
 			size_t offset = 0;
 			static thread_local uint8_t dest[CHUNK] = {0};
-			auto& stream = stream_container.get();
 
 			do
 			{
-				const auto input_size = std::min(sizeof(dest), data.size() - offset);
-				stream.avail_in = static_cast<uInt>(input_size);
-				stream.next_in = reinterpret_cast<const Bytef*>(data.data()) + offset;
-				offset += stream.avail_in;
+				set_input(*stream, data, offset);
 
 				do
 				{
-					stream.avail_out = sizeof(dest);
-					stream.next_out = dest;
+					stream->avail_out = sizeof(dest);
+					stream->next_out = dest;
 
-					ret = inflate(&stream, Z_NO_FLUSH);
-					if (ret != Z_OK && ret != Z_STREAM_END)
+					ret = inflate(stream, Z_NO_FLUSH);
+					if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
 					{
-						return {};
+						return false;
 					}
 
-					buffer.insert(buffer.end(), dest, dest + sizeof(dest) - stream.avail_out);
+					const auto size = sizeof(dest) - stream->avail_out;
+					if (size && !callback(reinterpret_cast<const char*>(dest), size))
+					{
+						return false;
+					}
+				}
+				while (stream->avail_out == 0);
+
+				if (ret != Z_STREAM_END && offset == data.size() && !stream->avail_in)
+				{
+					return false; // Truncated input
 				}
-				while (stream.avail_out == 0);
 			}
 			while (ret != Z_STREAM_END);
 
-			return buffer;
+			return true;
 		}
 
-		std::string compress(const std::string& data)
+		std::string compress(const std::string_view data, const int level)
 		{
+			auto* stream = get_deflater().begin(level);
+			if (!stream)
+			{
+				return {};
+			}
+
 			std::string result{};
-			auto length = compressBound(static_cast<uLong>(data.size()));
-			result.resize(length);
 
-			if (compress2(reinterpret_cast<Bytef*>(result.data()), &length,
-			              reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()),
-			              Z_BEST_COMPRESSION) != Z_OK)
+			if (data.size() <= max_stream_size)
 			{
-				return {};
+				result.resize(deflateBound(stream, static_cast<uLong>(data.size())));
+
+				stream->avail_in = static_cast<uInt>(data.size());
+				stream->next_in = reinterpret_cast<const Bytef*>(data.data());
+				stream->avail_out = static_cast<uInt>(result.size());
+				stream->next_out = reinterpret_cast<Bytef*>(result.data());
+
+				if (deflate(stream, Z_FINISH) != Z_STREAM_END)
+				{
+					return {};
+				}
+
+				result.resize(stream->total_out);
+				return result;
 			}
 
-			result.resize(length);
-			return result;
+			const auto success = compress(data, [&result](const char* chunk, const size_t size)
+			{
+				result.append(chunk, size);
+				return true;
+			}, level);
+
+			return success ? result : std::string{};
+		}
+
+		bool compress(const std::string_view data, const chunk_callback& callback, const int level)
+		{
+			auto* stream = get_deflater().begin(level);
+			if (!stream)
+			{
+				return false;
+			}
+
+			int ret{};
+			int flush{};
+			size_t offset = 0;
+			static thread_local uint8_t dest[CHUNK] = {0};
+
+			do
+			{
+				set_input(*stream, data, offset);
+				flush = offset == data.size() ? Z_FINISH : Z_NO_FLUSH;
+
+				do
+				{
+					stream->avail_out = sizeof(dest);
+					stream->next_out = dest;
+
+					ret = deflate(stream, flush);
+					if (ret == Z_STREAM_ERROR)
+					{
+						return false;
+					}
+
+					const auto size = sizeof(dest) - stream->avail_out;
+					if (size && !callback(reinterpret_cast<const char*>(dest), size))
+					{
+						return false;
+					}
+				}
+				while (stream->avail_out == 0);
+			}
+			while (flush != Z_FINISH);
+
+			return ret == Z_STREAM_END;
 		}
 	}
 
@@ -115,30 +306,170 @@ namespace utils::compression
 	{
 		namespace
 		{
-			bool add_file(zipFile& zip_file, const std::string& filename, const std::string& data)
+			constexpr size_t max_write_size = 1u << 30;
+
+			struct compressed_entry
+			{
+				bool ready{false};
+				bool valid{false};
+				uint64_t size{};
+				uLong crc{};
+
+				// Empty for stored in-memory entries, those are written straight from the archive
+				std::optional<std::string> data{};
+			};
+
+			uLong compute_crc(const std::string_view data)
 			{
-				const auto zip_64 = data.size() > 0xffffffff ? 1 : 0;
-				if (ZIP_OK != zipOpenNewFileInZip64(zip_file, filename.data(), nullptr, nullptr, 0, nullptr, 0, nullptr,
-				                                    Z_DEFLATED, Z_BEST_COMPRESSION, zip_64))
+				auto crc = crc32(0, nullptr, 0);
+				for (size_t offset = 0; offset < data.size(); offset += max_write_size)
+				{
+					const auto size = std::min(max_write_size, data.size() - offset);
+					crc = crc32(crc, reinterpret_cast<const Bytef*>(data.data()) + offset, static_cast<uInt>(size));
+				}
+
+				return crc;
+			}
+
+			// Zip entries hold raw deflate data, without the zlib header and trailer
+			bool deflate_raw(const std::string_view data, const int level, std::string& output)
+			{
+				z_stream stream{};
+				if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
 				{
 					return false;
 				}
 
-				const auto _ = gsl::finally([&zip_file]()
+				const auto _ = gsl::finally([&stream]()
 				{
-					zipCloseFileInZip(zip_file);
+					deflateEnd(&stream);
 				});
 
-				return ZIP_OK == zipWriteInFileInZip(zip_file, data.data(), static_cast<unsigned>(data.size()));
+				output.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+
+				int ret{};
+				size_t input_offset = 0;
+				size_t output_offset = 0;
+
+				do
+				{
+					const auto input_size = std::min(max_write_size, data.size() - input_offset);
+					stream.avail_in = static_cast<uInt>(input_size);
+					stream.next_in = reinterpret_cast<const Bytef*>(data.data()) + input_offset;
+					input_offset += input_size;
+
+					const auto flush = input_offset == data.size() ? Z_FINISH : Z_NO_FLUSH;
+
+					do
+					{
+						if (output_offset == output.size())
+						{
+							output.resize(output.size() * 2);
+						}
+
+						const auto output_size = std::min(max_write_size, output.size() - output_offset);
+						stream.avail_out = static_cast<uInt>(output_size);
+						stream.next_out = reinterpret_cast<Bytef*>(output.data()) + output_offset;
+
+						ret = deflate(&stream, flush);
+						output_offset += output_size - stream.avail_out;
+
+						if (ret == Z_STREAM_ERROR)
+						{
+							return false;
+						}
+					}
+					while (stream.avail_out == 0);
+				}
+				while (input_offset < data.size());
+
+				output.resize(output_offset);
+				return ret == Z_STREAM_END;
 			}
+
+			compressed_entry compress_entry(const std::string& source, const std::string& path,
+			                                const compression_method method, const int level)
+			{
+				compressed_entry result{};
+
+				std::string buffer{};
+				std::string_view input = source;
+
+				if (!path.empty())
+				{
+					if (!io::read_file(path, &buffer))
+					{
+						return result;
+					}
+
+					input = buffer;
+				}
+
+				result.size = input.size();
+				result.crc = compute_crc(input);
+
+				if (method == compression_method::store)
+				{
+					if (!path.empty())
+					{
+						result.data = std::move(buffer);
+					}
+
+					result.valid = true;
+					return result;
+				}
+
+				result.data.emplace();
+				result.valid = deflate_raw(input, level, *result.data);
+				return result;
+			}
+
+			bool write_entry(zipFile& zip_file, const std::string& filename, const std::string_view data,
+			                 const compressed_entry& entry, const compression_method method, const int level)
+			{
+				const auto zip_64 = entry.size > 0xffffffff ? 1 : 0;
+				const auto stored = method == compression_method::store;
+
+				if (ZIP_OK != zipOpenNewFileInZip2_64(zip_file, filename.data(), nullptr, nullptr, 0, nullptr, 0, nullptr,
+				                                      stored ? 0 : Z_DEFLATED, stored ? 0 : level, 1, zip_64))
+				{
+					return false;
+				}
+
+				auto success = true;
+				for (size_t offset = 0; success && offset < data.size(); offset += max_write_size)
+				{
+					const auto size = std::min(max_write_size, data.size() - offset);
+					success = ZIP_OK == zipWriteInFileInZip(zip_file, data.data() + offset, static_cast<unsigned>(size));
+				}
+
+				return ZIP_OK == zipCloseFileInZipRaw64(zip_file, entry.size, entry.crc) && success;
+			}
+		}
+
+		void archive::add(std::string filename, std::string data, const compression_method method)
+		{
+			this->add_entry({std::move(filename), std::move(data), {}, method});
 		}
 
-		void archive::add(std::string filename, std::string data)
+		void archive::add_file(std::string filename, std::string path, const compression_method method)
 		{
-			this->files_[std::move(filename)] = std::move(data);
+			this->add_entry({std::move(filename), {}, std::move(path), method});
 		}
 
-		bool archive::write(const std::string& filename, const std::string& comment)
+		void archive::add_entry(entry entry)
+		{
+			const auto existing = std::ranges::find(this->entries_, entry.filename, &archive::entry::filename);
+			if (existing != this->entries_.end())
+			{
+				*existing = std::move(entry);
+				return;
+			}
+
+			this->entries_.push_back(std::move(entry));
+		}
+
+		bool archive::write(const std::string& filename, const std::string& comment, const int level)
 		{
 			// Hack to create the directory :3
 			io::write_file(filename, {});
@@ -155,15 +486,94 @@ namespace utils::compression
 				zipClose(zip_file, comment.empty() ? nullptr : comment.data());
 			});
 
-			for (const auto& file : this->files_)
+			const auto entry_count = this->entries_.size();
+			const auto worker_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 4);
+
+			// Workers may only run this far ahead of the writer, which bounds the memory held by finished entries
+			const auto window = worker_count * 2;
+
+			std::mutex mutex{};
+			std::condition_variable condition{};
+			std::vector<compressed_entry> results(entry_count);
+			size_t next_entry = 0;
+			size_t written = 0;
+			auto abort = false;
+
+			const auto worker = [&]()
 			{
-				if (!add_file(zip_file, file.first, file.second))
+				while (true)
 				{
-					return false;
+					size_t index{};
+
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						if (abort || next_entry >= entry_count) return;
+
+						index = next_entry++;
+						condition.wait(lock, [&]()
+						{
+							return abort || index < written + window;
+						});
+
+						if (abort) return;
+					}
+
+					const auto& source = this->entries_[index];
+					auto result = compress_entry(source.data, source.path, source.method, level);
+
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						results[index] = std::move(result);
+						results[index].ready = true;
+					}
+
+					condition.notify_all();
 				}
+			};
+
+			std::vector<std::thread> workers{};
+			workers.reserve(std::min(worker_count, entry_count));
+
+			for (size_t i = 0; i < std::min(worker_count, entry_count); ++i)
+			{
+				workers.emplace_back(worker);
 			}
 
-			return true;
+			auto success = true;
+			for (size_t i = 0; i < entry_count && success; ++i)
+			{
+				compressed_entry result{};
+
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					condition.wait(lock, [&]()
+					{
+						return results[i].ready;
+					});
+
+					result = std::move(results[i]);
+				}
+
+				const auto& source = this->entries_[i];
+				const std::string_view data = result.data ? std::string_view{*result.data} : std::string_view{source.data};
+
+				success = result.valid && write_entry(zip_file, source.filename, data, result, source.method, level);
+
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					++written;
+					abort = !success;
+				}
+
+				condition.notify_all();
+			}
+
+			for (auto& worker_thread : workers)
+			{
+				worker_thread.join();
+			}
+
+			return success;
 		}
 	}
 }
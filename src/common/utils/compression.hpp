@@ -1,7 +1,9 @@
 #pragma once
 
+#include <functional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 #define CHUNK 16384u
 
@@ -9,20 +11,53 @@ namespace utils::compression
 {
 	namespace zlib
 	{
-		std::string compress(const std::string& data);
-		std::string decompress(const std::string& data);
+		// Mirrors zlib's Z_DEFAULT_COMPRESSION, Z_BEST_SPEED and Z_BEST_COMPRESSION
+		constexpr int default_compression = -1;
+		constexpr int best_speed = 1;
+		constexpr int best_compression = 9;
+
+		// Receives the output piece by piece, return false to abort
+		using chunk_callback = std::function<bool(const char* data, size_t size)>;
+
+		std::string compress(std::string_view data, int level = best_compression);
+		bool compress(std::string_view data, const chunk_callback& callback, int level = best_compression);
+
+		// size_hint is the expected decompressed size, the output grows past it if needed
+		std::string decompress(std::string_view data, size_t size_hint = 0);
+		bool decompress(std::string_view data, const chunk_callback& callback);
 	}
 
 	namespace zip
 	{
+		enum class compression_method
+		{
+			deflate,
+			store, // For inputs that are already compressed
+		};
+
 		class archive
 		{
 		public:
-			void add(std::string filename, std::string data);
-			bool write(const std::string& filename, const std::string& comment = {});
+			void add(std::string filename, std::string data, compression_method method = compression_method::deflate);
+
+			// The file is only read while the archive is written
+			void add_file(std::string filename, std::string path, compression_method method = compression_method::deflate);
+
+			// Entries are compressed in parallel and written in the order they were added
+			bool write(const std::string& filename, const std::string& comment = {}, int level = zlib::best_compression);
 
 		private:
-			std::unordered_map<std::string, std::string> files_;
+			struct entry
+			{
+				std::string filename;
+				std::string data;
+				std::string path;
+				compression_method method;
+			};
+
+			std::vector<entry> entries_;
+
+			void add_entry(entry entry);
 		};
 	}
 };
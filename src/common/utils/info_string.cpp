@@ -1,64 +1,144 @@
 #include "info_string.hpp"
-#include "string.hpp"
 
 namespace utils
 {
-	info_string::info_string(const std::string& buffer)
+	info_string_view::info_string_view(const std::string_view buffer)
 	{
 		this->parse(buffer);
 	}
 
-	info_string::info_string(const std::string_view& buffer)
-		: info_string(std::string{buffer})
+	std::string_view info_string_view::get(const std::string_view key) const
 	{
+		for (const auto& [entry_key, value] : this->key_value_pairs_)
+		{
+			if (entry_key == key)
+			{
+				return value;
+			}
+		}
+
+		return {};
 	}
 
-	void info_string::set(const std::string& key, const std::string& value)
+	size_t info_string_view::size() const
 	{
-		this->key_value_pairs_[key] = value;
+		return this->key_value_pairs_.size();
 	}
 
-	std::string info_string::get(const std::string& key) const
+	void info_string_view::parse(std::string_view buffer)
 	{
-		const auto value = this->key_value_pairs_.find(key);
-		if (value != this->key_value_pairs_.end())
+		if (!buffer.empty() && buffer[0] == '\\')
 		{
-			return value->second;
+			buffer.remove_prefix(1);
 		}
 
-		return {};
+		std::string_view key{};
+		auto has_key = false;
+
+		while (!buffer.empty())
+		{
+			const auto end = buffer.find('\\');
+			const auto token = buffer.substr(0, end);
+			buffer.remove_prefix(end == std::string_view::npos ? buffer.size() : end + 1);
+
+			if (!has_key)
+			{
+				key = token;
+				has_key = true;
+				continue;
+			}
+
+			has_key = false;
+
+			// Later duplicates win, but keep the position of the first occurrence
+			auto found = false;
+			for (auto& entry : this->key_value_pairs_)
+			{
+				if (entry.first == key)
+				{
+					entry.second = token;
+					found = true;
+					break;
+				}
+			}
+
+			if (!found)
+			{
+				this->key_value_pairs_.emplace_back(key, token);
+			}
+		}
+	}
+
+	info_string::info_string(const std::string& buffer)
+		: info_string(info_string_view{buffer})
+	{
+	}
+
+	info_string::info_string(const std::string_view& buffer)
+		: info_string(info_string_view{buffer})
+	{
 	}
 
-	void info_string::parse(std::string buffer)
+	info_string::info_string(const info_string_view& view)
 	{
-		if (buffer[0] == '\\')
+		this->key_value_pairs_.reserve(view.size());
+		view.for_each([this](const std::string_view key, const std::string_view value)
 		{
-			buffer = buffer.substr(1);
+			this->key_value_pairs_.emplace_back(key, value);
+		});
+	}
+
+	void info_string::set(const std::string& key, const std::string& value)
+	{
+		for (auto& entry : this->key_value_pairs_)
+		{
+			if (entry.first == key)
+			{
+				entry.second = value;
+				return;
+			}
 		}
 
-		const auto key_values = string::split(buffer, '\\');
-		for (size_t i = 0; !key_values.empty() && i < (key_values.size() - 1); i += 2)
+		this->key_value_pairs_.emplace_back(key, value);
+	}
+
+	std::string info_string::get(const std::string& key) const
+	{
+		for (const auto& [entry_key, value] : this->key_value_pairs_)
 		{
-			const auto& key = key_values[i];
-			const auto& value = key_values[i + 1];
-			this->key_value_pairs_[key] = value;
+			if (entry_key == key)
+			{
+				return value;
+			}
 		}
+
+		return {};
 	}
 
 	std::string info_string::build() const
 	{
-		//auto first = true;
 		std::string info_string;
-		for (const auto& [key, val] : key_value_pairs_)
-		{
-			//if (first) first = false;
-			/*else*/ info_string.append("\\");
+		this->build(info_string);
+		return info_string;
+	}
 
-			info_string.append(key); // Key
-			info_string.append("\\");
-			info_string.append(val); // Value
+	void info_string::build(std::string& buffer) const
+	{
+		size_t size = 0;
+		for (const auto& [key, val] : this->key_value_pairs_)
+		{
+			size += key.size() + val.size() + 2;
 		}
 
-		return info_string;
+		buffer.clear();
+		buffer.reserve(size);
+
+		for (const auto& [key, val] : this->key_value_pairs_)
+		{
+			buffer.push_back('\\');
+			buffer.append(key); // Key
+			buffer.push_back('\\');
+			buffer.append(val); // Value
+		}
 	}
 }
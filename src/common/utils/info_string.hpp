@@ -1,24 +1,50 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 namespace utils
 {
+	// Non-owning parser, the viewed buffer must outlive this object
+	class info_string_view
+	{
+	public:
+		info_string_view() = default;
+		info_string_view(std::string_view buffer);
+
+		std::string_view get(std::string_view key) const;
+		size_t size() const;
+
+		template <typename F>
+		void for_each(F&& callback) const
+		{
+			for (const auto& [key, value] : this->key_value_pairs_)
+			{
+				callback(key, value);
+			}
+		}
+
+	private:
+		std::vector<std::pair<std::string_view, std::string_view>> key_value_pairs_{};
+
+		void parse(std::string_view buffer);
+	};
+
 	class info_string
 	{
 	public:
 		info_string() = default;
 		info_string(const std::string& buffer);
 		info_string(const std::string_view& buffer);
+		info_string(const info_string_view& view);
 
 		void set(const std::string& key, const std::string& value);
 		std::string get(const std::string& key) const;
 		std::string build() const;
+		void build(std::string& buffer) const;
 
 	private:
-		std::unordered_map<std::string, std::string> key_value_pairs_{};
-
-		void parse(std::string buffer);
+		std::vector<std::pair<std::string, std::string>> key_value_pairs_{};
 	};
 }
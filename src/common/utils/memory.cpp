@@ -1,10 +1,19 @@
 #include "memory.hpp"
 #include "nt.hpp"
 
+#include <algorithm>
+#include <cstddef>
+
 namespace utils
 {
 	memory::allocator memory::mem_allocator_;
 
+	namespace
+	{
+		constexpr size_t arena_block_size = 0x10000;
+		constexpr size_t arena_alignment = alignof(std::max_align_t);
+	}
+
 	memory::allocator::~allocator()
 	{
 		this->clear();
@@ -14,21 +23,37 @@ namespace utils
 	{
 		std::lock_guard _(this->mutex_);
 
-		for (const auto& data : this->pool_)
+		for (const auto& allocation : this->pool_)
 		{
-			memory::free(data);
+			memory::free(allocation.first);
+		}
+
+		for (const auto& block : this->arena_blocks_)
+		{
+			memory::free(block);
 		}
 
 		this->pool_.clear();
+		this->arena_blocks_.clear();
+		this->arena_current_ = nullptr;
+		this->arena_remaining_ = 0;
+
+		this->statistics_.live_bytes = 0;
+		this->statistics_.live_allocations = 0;
+		this->statistics_.arena_bytes = 0;
+		this->statistics_.arena_capacity = 0;
 	}
 
 	void memory::allocator::free(void* data)
 	{
 		std::lock_guard _(this->mutex_);
 
-		const auto j = std::find(this->pool_.begin(), this->pool_.end(), data);
+		const auto j = this->pool_.find(data);
 		if (j != this->pool_.end())
 		{
+			this->statistics_.live_bytes -= j->second;
+			--this->statistics_.live_allocations;
+
 			memory::free(data);
 			this->pool_.erase(j);
 		}
@@ -42,23 +67,76 @@ namespace utils
 	void* memory::allocator::allocate(const size_t length)
 	{
 		std::lock_guard _(this->mutex_);
+		return this->track(memory::allocate(length), length);
+	}
+
+	void* memory::allocator::allocate_arena(const size_t length)
+	{
+		std::lock_guard _(this->mutex_);
+
+		const auto size = (std::max(length, size_t(1)) + arena_alignment - 1) & ~(arena_alignment - 1);
+
+		// Large requests get a block of their own, so they don't waste the rest of the current one
+		if (size > arena_block_size / 4)
+		{
+			auto* block = memory::allocate(size);
+			if (!block) return nullptr;
+
+			this->arena_blocks_.push_back(block);
+			this->statistics_.arena_bytes += size;
+			this->statistics_.arena_capacity += size;
+			++this->statistics_.allocation_count;
+			return block;
+		}
+
+		if (size > this->arena_remaining_)
+		{
+			auto* block = memory::allocate(arena_block_size);
+			if (!block) return nullptr;
 
-		const auto data = memory::allocate(length);
-		this->pool_.push_back(data);
+			this->arena_blocks_.push_back(block);
+			this->arena_current_ = static_cast<char*>(block);
+			this->arena_remaining_ = arena_block_size;
+			this->statistics_.arena_capacity += arena_block_size;
+		}
+
+		auto* data = this->arena_current_;
+		this->arena_current_ += size;
+		this->arena_remaining_ -= size;
+
+		this->statistics_.arena_bytes += size;
+		++this->statistics_.allocation_count;
 		return data;
 	}
 
 	bool memory::allocator::empty() const
 	{
-		return this->pool_.empty();
+		return this->pool_.empty() && this->arena_blocks_.empty();
 	}
 
 	char* memory::allocator::duplicate_string(const std::string& string)
 	{
 		std::lock_guard _(this->mutex_);
+		return static_cast<char*>(this->track(memory::duplicate_string(string), string.size() + 1));
+	}
+
+	memory::allocator::statistics memory::allocator::get_statistics() const
+	{
+		std::lock_guard _(this->mutex_);
+		return this->statistics_;
+	}
+
+	void* memory::allocator::track(void* data, const size_t length)
+	{
+		if (!data) return nullptr;
+
+		this->pool_.emplace(data, length);
+
+		this->statistics_.live_bytes += length;
+		this->statistics_.peak_bytes = std::max(this->statistics_.peak_bytes, this->statistics_.live_bytes);
+		++this->statistics_.live_allocations;
+		++this->statistics_.allocation_count;
 
-		const auto data = memory::duplicate_string(string);
-		this->pool_.push_back(data);
 		return data;
 	}
 
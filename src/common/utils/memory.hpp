@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace utils
@@ -33,13 +34,50 @@ namespace utils
 				return static_cast<T*>(this->allocate(count * sizeof(T)));
 			}
 
+			// Arena allocations are bump allocated and only released by clear()
+			void* allocate_arena(size_t length);
+
+			template <typename T>
+			T* allocate_arena()
+			{
+				return this->allocate_arena_array<T>(1);
+			}
+
+			template <typename T>
+			T* allocate_arena_array(const size_t count = 1)
+			{
+				return static_cast<T*>(this->allocate_arena(count * sizeof(T)));
+			}
+
 			bool empty() const;
 
 			char* duplicate_string(const std::string& string);
 
+			struct statistics
+			{
+				size_t live_bytes;
+				size_t peak_bytes;
+				size_t live_allocations;
+				size_t allocation_count;
+				size_t arena_bytes;
+				size_t arena_capacity;
+			};
+
+			statistics get_statistics() const;
+
 		private:
-			std::mutex mutex_;
-			std::vector<void*> pool_;
+			mutable std::mutex mutex_;
+
+			// Tracked allocations and their size
+			std::unordered_map<void*, size_t> pool_;
+
+			std::vector<void*> arena_blocks_;
+			char* arena_current_ = nullptr;
+			size_t arena_remaining_ = 0;
+
+			statistics statistics_{};
+
+			void* track(void* data, size_t length);
 		};
 
 		static void* allocate(size_t length);
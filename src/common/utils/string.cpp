@@ -2,6 +2,7 @@
 #include <sstream>
 #include <cstdarg>
 #include <algorithm>
+#include <cstring>
 
 #include "nt.hpp"
 
@@ -20,6 +21,23 @@ namespace utils::string
 		return result;
 	}
 
+	std::string& get_format_buffer()
+	{
+		static thread_local std::string buffers[8];
+		static thread_local size_t current_buffer = 0;
+
+		++current_buffer %= ARRAY_COUNT(buffers);
+
+		// Buffers only ever grow, formatting writes into their full size
+		auto& buffer = buffers[current_buffer];
+		if (buffer.size() < 256)
+		{
+			buffer.resize(256);
+		}
+
+		return buffer;
+	}
+
 	std::vector<std::string> split(const std::string& s, const char delim)
 	{
 		std::stringstream ss(s);
@@ -72,18 +90,29 @@ namespace utils::string
 		return std::to_string(atoi(text.data())) == text;
 	}
 
-	std::string dump_hex(const std::string& data, const std::string& separator)
+	std::string dump_hex(const std::string_view data, const std::string_view separator)
 	{
-		std::string result;
+		constexpr char hex_digits[] = "0123456789ABCDEF";
+
+		if (data.empty())
+		{
+			return {};
+		}
+
+		std::string result(data.size() * 2 + (data.size() - 1) * separator.size(), '\0');
+		auto* output = result.data();
 
-		for (unsigned int i = 0; i < data.size(); ++i)
+		for (size_t i = 0; i < data.size(); ++i)
 		{
 			if (i > 0)
 			{
-				result.append(separator);
+				std::memcpy(output, separator.data(), separator.size());
+				output += separator.size();
 			}
 
-			result.append(va("%02X", data[i] & 0xFF));
+			const auto value = static_cast<unsigned char>(data[i]);
+			*output++ = hex_digits[value >> 4];
+			*output++ = hex_digits[value & 0xF];
 		}
 
 		return result;
@@ -1,6 +1,8 @@
 #pragma once
 #include "memory.hpp"
 #include <cstdint>
+#include <format>
+#include <string_view>
 
 template <class Type, size_t n>
 constexpr auto ARRAY_COUNT(Type(&)[n]) { return n; }
@@ -78,6 +80,36 @@ namespace utils::string
 
 	const char* va(const char* fmt, ...);
 
+	// Lets std::string keyed unordered containers be searched with string_views without allocating
+	struct transparent_hash
+	{
+		using is_transparent = void;
+
+		size_t operator()(const std::string_view value) const
+		{
+			return std::hash<std::string_view>{}(value);
+		}
+	};
+
+	std::string& get_format_buffer();
+
+	// Like va, but the format string is checked at compile time and the ring buffers are reused without reallocating
+	template <typename... Args>
+	const char* va_format(const std::format_string<const Args&...> fmt, const Args&... args)
+	{
+		auto& buffer = get_format_buffer();
+
+		auto result = std::format_to_n(buffer.data(), buffer.size() - 1, fmt, args...);
+		if (static_cast<size_t>(result.size) >= buffer.size())
+		{
+			buffer.resize(result.size + 1);
+			result = std::format_to_n(buffer.data(), buffer.size() - 1, fmt, args...);
+		}
+
+		*result.out = '\0';
+		return buffer.data();
+	}
+
 	std::vector<std::string> split(const std::string& s, char delim);
 
 	std::string to_lower(const std::string& text);
@@ -86,7 +118,7 @@ namespace utils::string
 	bool ends_with(const std::string& text, const std::string& substring);
 	bool is_numeric(const std::string& text);
 
-	std::string dump_hex(const std::string& data, const std::string& separator = " ");
+	std::string dump_hex(std::string_view data, std::string_view separator = " ");
 
 	std::string get_clipboard_data();
 